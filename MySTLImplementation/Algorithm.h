@@ -1,16 +1,34 @@
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <concepts>
 #include <algorithm>
+#include <iterator>
+#include <memory>
+#include <functional>
+#include <type_traits>
+
+#include "Platform.h"
 
 constexpr inline int32_t IndexNone = -1;
 
+/* Anything that exposes contiguous memory through GetData/GetNumElements (TArray, TStaticArray, TSpan) */
+template <typename RangeType>
+concept TContiguousRange = requires(const RangeType & range)
+{
+    range.GetData();
+    { range.GetNumElements() } -> std::convertible_to<int32_t>;
+};
+
 class Arrays
 {
 public:
+    /* When one input of set algorithm is this many times larger than the other, binary galloping is used instead of linear merge */
+    constexpr static int32_t GallopRatio = 32;
+
     template <typename ElementType>
-    static int32_t Find(const ElementType* begin, const ElementType* end, const ElementType& element)
+    constexpr static int32_t Find(const ElementType* begin, const ElementType* end, const ElementType& element)
     {
         for (const ElementType* i = begin; i != end; ++i)
         {
@@ -24,7 +42,7 @@ public:
     }
 
     template <typename ElementType, std::predicate<const ElementType> Predicate>
-    static int32_t FindPredicate(const ElementType* begin, const ElementType* end, Predicate&& predicate)
+    constexpr static int32_t FindPredicate(const ElementType* begin, const ElementType* end, Predicate&& predicate)
     {
         for (const ElementType* i = begin; i != end; ++i)
         {
@@ -38,9 +56,484 @@ public:
     }
 
     template <typename ElementType, typename Compare>
-    static void Sort(ElementType* begin, ElementType* end, Compare&& comparator)
+    constexpr static void Sort(ElementType* begin, ElementType* end, Compare&& comparator)
     {
         std::sort(begin, end, std::forward<Compare>(comparator));
     }
-};
 
+    /* Returns first element not less than value in sorted range */
+    template <typename ElementType, typename ValueType, typename Compare>
+    constexpr static ElementType* LowerBound(ElementType* begin, ElementType* end, const ValueType& value, Compare&& comparator)
+    {
+        return std::lower_bound(begin, end, value, comparator);
+    }
+
+    /* Returns first element greater than value in sorted range */
+    template <typename ElementType, typename ValueType, typename Compare>
+    constexpr static ElementType* UpperBound(ElementType* begin, ElementType* end, const ValueType& value, Compare&& comparator)
+    {
+        return std::upper_bound(begin, end, value, comparator);
+    }
+
+    /* Returns index of element equal to value in sorted range or IndexNone */
+    template <typename ElementType, typename ValueType, typename Compare>
+    constexpr static int32_t BinarySearch(ElementType* begin, ElementType* end, const ValueType& value, Compare&& comparator)
+    {
+        ElementType* i = LowerBound(begin, end, value, comparator);
+
+        if (i != end && !comparator(value, *i))
+        {
+            return static_cast<int32_t>(i - begin);
+        }
+
+        return IndexNone;
+    }
+
+    /* Places element, which would be at nth position in sorted range, at nth. Elements before it are not greater, after it not less */
+    template <typename ElementType, typename Compare>
+    static void NthElement(ElementType* begin, ElementType* nth, ElementType* end, Compare&& comparator)
+    {
+        std::nth_element(begin, nth, end, std::forward<Compare>(comparator));
+    }
+
+    /* Sorts only [begin, middle) smallest elements of the whole range in O(n log k) */
+    template <typename ElementType, typename Compare>
+    static void PartialSort(ElementType* begin, ElementType* middle, ElementType* end, Compare&& comparator)
+    {
+        std::partial_sort(begin, middle, end, std::forward<Compare>(comparator));
+    }
+
+    /*
+    * Bottom-up merge sort, which preserves order of equal elements.
+    * buffer must point to uninitialized storage for (end - begin) elements; it's left uninitialized on return
+    */
+    template <typename ElementType, typename Compare>
+    static void StableSort(ElementType* begin, ElementType* end, ElementType* buffer, Compare&& comparator)
+    {
+        intptr_t size = end - begin;
+
+        for (intptr_t i = 0; i < size; i += StableSortRunSize)
+        {
+            InsertionSort(begin + i, begin + std::min(i + StableSortRunSize, size), comparator);
+        }
+
+        if (size <= StableSortRunSize)
+        {
+            return;
+        }
+
+        std::uninitialized_move(begin, end, buffer);
+
+        ElementType* from = buffer;
+        ElementType* to = begin;
+
+        for (intptr_t width = StableSortRunSize; width < size; width *= 2)
+        {
+            for (intptr_t left = 0; left < size; left += 2 * width)
+            {
+                intptr_t middle = std::min(left + width, size);
+                intptr_t right = std::min(left + 2 * width, size);
+
+                std::merge(std::make_move_iterator(from + left), std::make_move_iterator(from + middle),
+                    std::make_move_iterator(from + middle), std::make_move_iterator(from + right), to + left, comparator);
+            }
+
+            std::swap(from, to);
+        }
+
+        if (from != begin)
+        {
+            std::move(from, from + size, begin);
+        }
+
+        std::destroy(buffer, buffer + size);
+    }
+
+    /*
+    * Streams over range keeping bounded heap of k best elements, so it costs O(n log k) instead of sorting whole range.
+    * Best elements are greatest by comparator; they are appended to outArray in descending order
+    */
+    template <TContiguousRange RangeType, typename OutArrayType, typename Compare = std::less<>>
+    static void TopK(const RangeType& range, int32_t k, OutArrayType& outArray, Compare comparator = Compare{})
+    {
+        int32_t start = outArray.GetNumElements();
+        int32_t numElements = range.GetNumElements();
+        const auto* data = range.GetData();
+
+        k = std::min(k, numElements);
+
+        if (k <= 0)
+        {
+            return;
+        }
+
+        outArray.AllocAbs(start + k);
+
+        /* Min-heap, so worst of kept elements is always on top */
+        auto heapCompare = [&comparator](const auto& a, const auto& b)
+        {
+            return comparator(b, a);
+        };
+
+        for (int32_t i = 0; i < k; ++i)
+        {
+            outArray.Add(data[i]);
+        }
+
+        auto* heap = outArray.GetData() + start;
+        std::make_heap(heap, heap + k, heapCompare);
+
+        for (int32_t i = k; i < numElements; ++i)
+        {
+            if (comparator(heap[0], data[i]))
+            {
+                std::pop_heap(heap, heap + k, heapCompare);
+                heap[k - 1] = data[i];
+                std::push_heap(heap, heap + k, heapCompare);
+            }
+        }
+
+        std::sort_heap(heap, heap + k, heapCompare);
+    }
+
+    /* Removes adjacent duplicates, returns new end of range. Elements past new end are left in moved-from state */
+    template <typename ElementType, typename EqualCompare>
+    static ElementType* Unique(ElementType* begin, ElementType* end, EqualCompare&& equal)
+    {
+        return std::unique(begin, end, std::forward<EqualCompare>(equal));
+    }
+
+    /* Sorts range and removes all duplicates, returns new end of range */
+    template <typename ElementType, typename Compare>
+    static ElementType* SortUnique(ElementType* begin, ElementType* end, Compare&& comparator)
+    {
+        Sort(begin, end, comparator);
+
+        /* Range is sorted, so neighbours a <= b are equal when !(a < b) */
+        return std::unique(begin, end, [&comparator](const ElementType& a, const ElementType& b)
+        {
+            return !comparator(a, b);
+        });
+    }
+
+    /* Exponential search for first element not less than value. Cost is logarithmic in distance from begin, not in size of range */
+    template <typename ElementType, typename Compare>
+    static const ElementType* GallopLowerBound(const ElementType* begin, const ElementType* end, const ElementType& value, Compare& comparator)
+    {
+        intptr_t size = end - begin;
+        intptr_t low = 0;
+        intptr_t step = 1;
+
+        while (step <= size && comparator(begin[step - 1], value))
+        {
+            low = step;
+            step *= 2;
+        }
+
+        intptr_t high = step <= size ? step - 1 : size;
+        return std::lower_bound(begin + low, begin + high, value, comparator);
+    }
+
+    /*
+    * Sorted set algorithms. Inputs must be sorted by comparator and contain no duplicates (see SortUnique).
+    * Results are appended to outArray (TArray or any container with Add/Append/AllocAbs)
+    */
+
+    template <TContiguousRange RangeA, TContiguousRange RangeB, typename OutArrayType, typename Compare = std::less<>>
+    static void Union(const RangeA& a, const RangeB& b, OutArrayType& outArray, Compare comparator = Compare{})
+    {
+        const auto* i = a.GetData();
+        const auto* aEnd = i + a.GetNumElements();
+        const auto* j = b.GetData();
+        const auto* bEnd = j + b.GetNumElements();
+
+        outArray.AllocAbs(outArray.GetNumElements() + a.GetNumElements() + b.GetNumElements());
+
+        if (IsSkewed(a.GetNumElements(), b.GetNumElements()))
+        {
+            bool bSmallIsA = a.GetNumElements() < b.GetNumElements();
+            const auto* small = bSmallIsA ? i : j;
+            const auto* smallEnd = bSmallIsA ? aEnd : bEnd;
+            const auto* large = bSmallIsA ? j : i;
+            const auto* largeEnd = bSmallIsA ? bEnd : aEnd;
+
+            for (; small != smallEnd; ++small)
+            {
+                const auto* position = GallopLowerBound(large, largeEnd, *small, comparator);
+                outArray.Append(large, static_cast<int32_t>(position - large));
+                large = position;
+
+                if (large != largeEnd && !comparator(*small, *large))
+                {
+                    /* Equal elements are taken from first range */
+                    outArray.Add(bSmallIsA ? *small : *large);
+                    ++large;
+                }
+                else
+                {
+                    outArray.Add(*small);
+                }
+            }
+
+            outArray.Append(large, static_cast<int32_t>(largeEnd - large));
+            return;
+        }
+
+        while (i != aEnd && j != bEnd)
+        {
+            if (comparator(*i, *j))
+            {
+                outArray.Add(*i++);
+            }
+            else if (comparator(*j, *i))
+            {
+                outArray.Add(*j++);
+            }
+            else
+            {
+                outArray.Add(*i++);
+                ++j;
+            }
+        }
+
+        outArray.Append(i, static_cast<int32_t>(aEnd - i));
+        outArray.Append(j, static_cast<int32_t>(bEnd - j));
+    }
+
+    template <TContiguousRange RangeA, TContiguousRange RangeB, typename OutArrayType, typename Compare = std::less<>>
+    static void Intersect(const RangeA& a, const RangeB& b, OutArrayType& outArray, Compare comparator = Compare{})
+    {
+        const auto* i = a.GetData();
+        const auto* aEnd = i + a.GetNumElements();
+        const auto* j = b.GetData();
+        const auto* bEnd = j + b.GetNumElements();
+
+        outArray.AllocAbs(outArray.GetNumElements() + std::min(a.GetNumElements(), b.GetNumElements()));
+
+        if (IsSkewed(a.GetNumElements(), b.GetNumElements()))
+        {
+            bool bSmallIsA = a.GetNumElements() < b.GetNumElements();
+            const auto* small = bSmallIsA ? i : j;
+            const auto* smallEnd = bSmallIsA ? aEnd : bEnd;
+            const auto* large = bSmallIsA ? j : i;
+            const auto* largeEnd = bSmallIsA ? bEnd : aEnd;
+
+            for (; small != smallEnd && large != largeEnd; ++small)
+            {
+                large = GallopLowerBound(large, largeEnd, *small, comparator);
+
+                if (large != largeEnd && !comparator(*small, *large))
+                {
+                    outArray.Add(bSmallIsA ? *small : *large);
+                    ++large;
+                }
+            }
+
+            return;
+        }
+
+        using ElementType = std::remove_cvref_t<decltype(*i)>;
+
+        if constexpr (CanUseSimdIntersect<ElementType, Compare>())
+        {
+            IntersectSimd(i, aEnd, j, bEnd, outArray);
+        }
+
+        while (i != aEnd && j != bEnd)
+        {
+            if (comparator(*i, *j))
+            {
+                ++i;
+            }
+            else if (comparator(*j, *i))
+            {
+                ++j;
+            }
+            else
+            {
+                outArray.Add(*i++);
+                ++j;
+            }
+        }
+    }
+
+    /* Appends elements of a, that are not present in b */
+    template <TContiguousRange RangeA, TContiguousRange RangeB, typename OutArrayType, typename Compare = std::less<>>
+    static void Difference(const RangeA& a, const RangeB& b, OutArrayType& outArray, Compare comparator = Compare{})
+    {
+        const auto* i = a.GetData();
+        const auto* aEnd = i + a.GetNumElements();
+        const auto* j = b.GetData();
+        const auto* bEnd = j + b.GetNumElements();
+
+        outArray.AllocAbs(outArray.GetNumElements() + a.GetNumElements());
+
+        if (IsSkewed(a.GetNumElements(), b.GetNumElements()))
+        {
+            if (a.GetNumElements() < b.GetNumElements())
+            {
+                for (; i != aEnd; ++i)
+                {
+                    j = GallopLowerBound(j, bEnd, *i, comparator);
+
+                    if (j == bEnd || comparator(*i, *j))
+                    {
+                        outArray.Add(*i);
+                    }
+                }
+            }
+            else
+            {
+                /* Copy whole runs of a between consecutive elements of b */
+                for (; j != bEnd && i != aEnd; ++j)
+                {
+                    const auto* position = GallopLowerBound(i, aEnd, *j, comparator);
+                    outArray.Append(i, static_cast<int32_t>(position - i));
+                    i = position;
+
+                    if (i != aEnd && !comparator(*j, *i))
+                    {
+                        ++i;
+                    }
+                }
+
+                outArray.Append(i, static_cast<int32_t>(aEnd - i));
+            }
+
+            return;
+        }
+
+        while (i != aEnd && j != bEnd)
+        {
+            if (comparator(*i, *j))
+            {
+                outArray.Add(*i++);
+            }
+            else if (comparator(*j, *i))
+            {
+                ++j;
+            }
+            else
+            {
+                ++i;
+                ++j;
+            }
+        }
+
+        outArray.Append(i, static_cast<int32_t>(aEnd - i));
+    }
+
+    /* Returns true if every element of b is present in a */
+    template <TContiguousRange RangeA, TContiguousRange RangeB, typename Compare = std::less<>>
+    static bool Includes(const RangeA& a, const RangeB& b, Compare comparator = Compare{})
+    {
+        const auto* i = a.GetData();
+        const auto* aEnd = i + a.GetNumElements();
+        const auto* j = b.GetData();
+        const auto* bEnd = j + b.GetNumElements();
+
+        if (b.GetNumElements() > a.GetNumElements())
+        {
+            return false;
+        }
+
+        bool bGallop = IsSkewed(a.GetNumElements(), b.GetNumElements());
+
+        for (; j != bEnd; ++j)
+        {
+            i = bGallop ? GallopLowerBound(i, aEnd, *j, comparator) : std::lower_bound(i, aEnd, *j, comparator);
+
+            if (i == aEnd || comparator(*j, *i))
+            {
+                return false;
+            }
+
+            ++i;
+        }
+
+        return true;
+    }
+
+private:
+    constexpr static intptr_t StableSortRunSize = 32;
+
+    template <typename ElementType, typename Compare>
+    static void InsertionSort(ElementType* begin, ElementType* end, Compare& comparator)
+    {
+        for (ElementType* i = begin + 1; i < end; ++i)
+        {
+            if (!comparator(*i, *(i - 1)))
+            {
+                continue;
+            }
+
+            ElementType value = std::move(*i);
+            ElementType* j = i;
+
+            for (; j != begin && comparator(value, *(j - 1)); --j)
+            {
+                *j = std::move(*(j - 1));
+            }
+
+            *j = std::move(value);
+        }
+    }
+
+    static bool IsSkewed(int32_t a, int32_t b)
+    {
+        return static_cast<int64_t>(std::min(a, b)) * GallopRatio < std::max(a, b);
+    }
+
+    template <typename ElementType, typename Compare>
+    constexpr static bool CanUseSimdIntersect()
+    {
+        using DecayedCompare = std::decay_t<Compare>;
+
+        return PLATFORM_SSE2 && std::is_integral_v<ElementType> && sizeof(ElementType) == 4 &&
+            (std::is_same_v<DecayedCompare, std::less<>> || std::is_same_v<DecayedCompare, std::less<ElementType>>);
+    }
+
+    /* Compares blocks of 4 x 4 keys at once (all rotations of b block against a block). Leaves tail for scalar loop */
+    template <typename ElementType, typename OutArrayType>
+    static void IntersectSimd(const ElementType*& a, const ElementType* aEnd, const ElementType*& b, const ElementType* bEnd, OutArrayType& outArray)
+    {
+#if PLATFORM_SSE2
+        while (aEnd - a >= 4 && bEnd - b >= 4)
+        {
+            __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+            __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+
+            __m128i matches = _mm_cmpeq_epi32(blockA, blockB);
+            blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+            blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+            blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+
+            int32_t mask = _mm_movemask_ps(_mm_castsi128_ps(matches));
+
+            for (int32_t k = 0; mask != 0; ++k, mask >>= 1)
+            {
+                if (mask & 1)
+                {
+                    outArray.Add(a[k]);
+                }
+            }
+
+            ElementType maxA = a[3];
+            ElementType maxB = b[3];
+
+            if (maxA <= maxB)
+            {
+                a += 4;
+            }
+
+            if (maxB <= maxA)
+            {
+                b += 4;
+            }
+        }
+#endif
+    }
+};
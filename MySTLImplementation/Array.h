@@ -9,9 +9,11 @@
 #include <initializer_list>
 #include <algorithm>
 #include <cassert>
+#include <functional>
 
 #include "Span.h"
 #include "Algorithm.h"
+#include "SortingNetwork.h"
 
 struct DefaultAllocator
 {
@@ -70,7 +72,7 @@ public:
         return true;
     }
 
-    TArrayIterator(ContainerType& container, int32_t index) :
+    constexpr TArrayIterator(ContainerType& container, int32_t index) :
         m_Container(&container),
         m_Index(index)
     {
@@ -79,35 +81,35 @@ public:
     TArrayIterator(const SelfIterator&) = default;
     TArrayIterator& operator=(const SelfIterator&) = default;
 
-    bool operator==(const SelfIterator& iterator)
+    constexpr bool operator==(const SelfIterator& iterator)
     {
         return iterator.m_Container == m_Container && iterator.m_Index == m_Index;
     }
 
-    bool operator!=(const SelfIterator& iterator)
+    constexpr bool operator!=(const SelfIterator& iterator)
     {
         return iterator.m_Container != m_Container || iterator.m_Index != m_Index;
     }
 
-    ValueType& operator*() const
+    constexpr ValueType& operator*() const
     {
         assert(HasValidIndex());
         return (*m_Container)[m_Index];
     }
 
-    ValueType& operator*()
+    constexpr ValueType& operator*()
     {
         assert(HasValidIndex());
         return (*m_Container)[m_Index];
     }
 
-    ValueType* operator->() const
+    constexpr ValueType* operator->() const
     {
         assert(HasValidIndex());
         return m_Container->GetData() + m_Index;
     }
 
-    SelfIterator& operator++()
+    constexpr SelfIterator& operator++()
     {
         assert(HasValidIndex());
         ++m_Index;
@@ -115,7 +117,7 @@ public:
         return *this;
     }
 
-    SelfIterator& operator--()
+    constexpr SelfIterator& operator--()
     {
         assert(HasValidIndex());
         --m_Index;
@@ -123,26 +125,26 @@ public:
         return *this;
     }
 
-    SelfIterator operator++(int)
+    constexpr SelfIterator operator++(int)
     {
         assert(HasValidIndex());
         SelfIterator it{m_Container, m_Index + 1};
         return it;
     }
 
-    SelfIterator operator--(int)
+    constexpr SelfIterator operator--(int)
     {
         assert(HasValidIndex());
         SelfIterator it{m_Container, m_Index - 1};
         return it;
     }
 
-    bool HasValidIndex()const
+    constexpr bool HasValidIndex()const
     {
         return m_Index >= 0 && m_Index < m_Container->GetNumElements();
     }
 
-    int32_t GetIndex() const
+    constexpr int32_t GetIndex() const
     {
         return m_Index;
     }
@@ -230,10 +232,12 @@ public:
 
     TArray& operator=(TArray<ElementType, AllocatorType>&& elements) noexcept
     {
-        m_Data = std::exchange(elements.m_Data, nullptr);
-        m_NumElements = std::exchange(elements.m_NumElements, 0);
-        m_NumAlloc = std::exchange(elements.m_NumAlloc, 0);
-        m_Allocator = std::exchange(elements.m_Allocator, AllocatorType{});
+        if (&elements != this)
+        {
+            /* Old elements and storage are released by destructor of temporary */
+            TArray<ElementType, AllocatorType> temp{std::move(elements)};
+            swap(temp);
+        }
 
         return *this;
     }
@@ -283,14 +287,25 @@ public:
         }
     }
 
+    /* Inserts element before index (index == GetNumElements() appends), shifting following elements by one */
     template <typename ...Args>
     void EmplaceAt(int32_t index, Args&& ...args)
     {
-        assert(index >= 0 && index < m_NumElements);
+        assert(index >= 0 && index <= m_NumElements);
+
+        if (index == m_NumElements)
+        {
+            EmplaceBack(std::forward<Args>(args)...);
+            return;
+        }
+
+        /* Constructed before growing, arguments may reference elements of this array */
+        ElementType element(std::forward<Args>(args)...);
         TryExpand();
 
-        std::move(&m_Data[index], &m_Data[m_NumElements], &m_Data[index + 1]);
-        m_Allocator.ConstructElement(&m_Data[index], std::forward<Args>(args)...);
+        m_Allocator.ConstructElement(&m_Data[m_NumElements], std::move(m_Data[m_NumElements - 1]));
+        std::move_backward(&m_Data[index], &m_Data[m_NumElements - 1], &m_Data[m_NumElements]);
+        m_Data[index] = std::move(element);
 
         m_NumElements++;
     }
@@ -319,7 +334,7 @@ public:
 
     void AddZeroed(int32_t numZeroed)
     {
-        AllocAbs(m_NumElements + numZeroed);
+        ReserveGrowth(m_NumElements + numZeroed);
 
         m_Allocator.ConstructDefaultRange(&m_Data[m_NumElements], &m_Data[m_NumElements + numZeroed]);
         m_NumElements += numZeroed;
@@ -329,7 +344,7 @@ public:
     {
         int32_t i = FindIndexOf(elementType);
 
-        if (i != IndexNone)
+        if (i == IndexNone)
         {
             return Add(elementType);
         }
@@ -356,7 +371,7 @@ public:
 
     void Append(const ElementType* data, int32_t size)
     {
-        AllocAbs(m_NumElements + size);
+        ReserveGrowth(m_NumElements + size);
 
         for (int32_t i = 0; i < size; ++i)
         {
@@ -368,7 +383,7 @@ public:
     template <typename OtherElementType, typename OtherAllocator>
     void Append(const TArray<OtherElementType, OtherAllocator>& elements)
     {
-        AllocAbs(m_NumElements + elements.GetNumElements());
+        ReserveGrowth(m_NumElements + elements.GetNumElements());
 
         for (const OtherElementType& element : elements)
         {
@@ -426,7 +441,7 @@ public:
     template <typename Predicate>
     bool ContainsByPredicate(Predicate&& predicate) const
     {
-        int32_t i = FindIndexOfByPredicate(std::forward<Predicate>(predicate)...);
+        int32_t i = FindIndexOfByPredicate(std::forward<Predicate>(predicate));
         return i != IndexNone;
     }
 
@@ -445,7 +460,20 @@ public:
         assert(index >= 0 && index < m_NumElements);
 
         std::move(&m_Data[index + 1], &m_Data[m_NumElements], &m_Data[index]);
-        m_NumElements--;
+        TruncateTo(m_NumElements - 1);
+    }
+
+    /* Removes element in O(1) by moving last element into its place. Doesn't preserve order */
+    void RemoveIndexSwap(int32_t index)
+    {
+        assert(IsValidIndex(index));
+
+        if (index != m_NumElements - 1)
+        {
+            m_Data[index] = std::move(m_Data[m_NumElements - 1]);
+        }
+
+        TruncateTo(m_NumElements - 1);
     }
 
     void Remove(const ElementType& type)
@@ -530,6 +558,77 @@ public:
         Sort(std::less<ElementType>{});
     }
 
+    template <typename Predicate>
+    void StableSort(Predicate&& predicate)
+    {
+        if (m_NumElements < 2)
+        {
+            return;
+        }
+
+        /* Merge buffer comes from the same allocator as array storage */
+        ElementType* buffer = (ElementType*)m_Allocator.Allocate(GetSizeBytes());
+        Arrays::StableSort(m_Data, m_Data + m_NumElements, buffer, predicate);
+        m_Allocator.Free(buffer);
+    }
+
+    void StableSort()
+    {
+        StableSort(std::less<ElementType>{});
+    }
+
+    /* Sorts only first count elements (the smallest ones), rest of array is left in unspecified order */
+    template <typename Predicate>
+    void PartialSort(int32_t count, Predicate&& predicate)
+    {
+        assert(count >= 0 && count <= m_NumElements);
+        Arrays::PartialSort(m_Data, m_Data + count, m_Data + m_NumElements, predicate);
+    }
+
+    void PartialSort(int32_t count)
+    {
+        PartialSort(count, std::less<ElementType>{});
+    }
+
+    /* Puts element, which would be at index after sorting, at this index in O(n) */
+    template <typename Predicate>
+    void NthElement(int32_t index, Predicate&& predicate)
+    {
+        assert(IsValidIndex(index));
+        Arrays::NthElement(m_Data, m_Data + index, m_Data + m_NumElements, predicate);
+    }
+
+    void NthElement(int32_t index)
+    {
+        NthElement(index, std::less<ElementType>{});
+    }
+
+    /* Removes adjacent duplicates. Sorted array ends up with unique elements */
+    template <typename EqualCompare>
+    void Unique(EqualCompare&& equal)
+    {
+        ElementType* newEnd = Arrays::Unique(m_Data, m_Data + m_NumElements, equal);
+        TruncateTo(static_cast<int32_t>(newEnd - m_Data));
+    }
+
+    void Unique()
+    {
+        Unique(std::equal_to<ElementType>{});
+    }
+
+    /* Sorts array and removes duplicates in O(n log n), instead of calling AddUnique for each element */
+    template <typename Predicate>
+    void SortUnique(Predicate&& predicate)
+    {
+        ElementType* newEnd = Arrays::SortUnique(m_Data, m_Data + m_NumElements, predicate);
+        TruncateTo(static_cast<int32_t>(newEnd - m_Data));
+    }
+
+    void SortUnique()
+    {
+        SortUnique(std::less<ElementType>{});
+    }
+
     template <typename Func>
     void Generate(Func&& func)
     {
@@ -611,6 +710,23 @@ private:
         }
     }
 
+    /* Grows geometrically like Add, so repeated appends of small ranges don't reallocate every time */
+    void ReserveGrowth(int32_t numElements)
+    {
+        if (numElements > m_NumAlloc)
+        {
+            AllocAbs(CalculateGrowth(numElements));
+        }
+    }
+
+    void TruncateTo(int32_t numElements)
+    {
+        assert(numElements >= 0 && numElements <= m_NumElements);
+
+        m_Allocator.DestroyRange(m_Data + numElements, m_Data + m_NumElements);
+        m_NumElements = numElements;
+    }
+
     int32_t CalculateGrowth(int32_t newCapacity)
     {
         int32_t cap = m_NumAlloc + m_NumAlloc / 2;
@@ -641,6 +757,7 @@ private:
     }
 };
 
+/* Fixed size array. Its algorithms are constexpr, so lookup tables built from it can be baked at compile time */
 template <typename ElementType, int32_t Size>
 struct TStaticArray
 {
@@ -649,7 +766,7 @@ struct TStaticArray
     using SelfClass = TStaticArray<ElementType, Size>;
 
     using Iterator = TArrayIterator<SelfClass, ValueType>;
-    using ConstIterator = TArrayIterator<SelfClass, ConstValueType>;
+    using ConstIterator = TArrayIterator<const SelfClass, ConstValueType>;
 
     ElementType Data[Size];
 
@@ -680,42 +797,42 @@ struct TStaticArray
         return Data;
     }
 
-    Iterator begin()
+    constexpr Iterator begin()
     {
         return Iterator{*this, 0};
     }
 
-    ConstIterator begin() const
+    constexpr ConstIterator begin() const
     {
         return ConstIterator{*this, 0};
     }
 
-    Iterator end()
+    constexpr Iterator end()
     {
         return Iterator{*this, Size};
     }
 
-    ConstIterator end() const
+    constexpr ConstIterator end() const
     {
         return ConstIterator{*this, Size};
     }
 
-    ElementType* UncheckedBegin()
+    constexpr ElementType* UncheckedBegin()
     {
         return Data;
     }
 
-    const ElementType* UncheckedBegin() const
+    constexpr const ElementType* UncheckedBegin() const
     {
         return Data;
     }
 
-    ElementType* UncheckedEnd()
+    constexpr ElementType* UncheckedEnd()
     {
         return Data + Size;
     }
 
-    const ElementType* UncheckedEnd() const
+    constexpr const ElementType* UncheckedEnd() const
     {
         return Data + Size;
     }
@@ -730,37 +847,68 @@ struct TStaticArray
         return static_cast<intptr_t>(Size) * sizeof(ElementType);
     }
 
-    int32_t FindIndexOf(const ElementType& type) const
+    constexpr int32_t FindIndexOf(const ElementType& type) const
     {
         return Arrays::Find(Data, Data + Size, type);
     }
 
     template <typename Predicate>
-    int32_t FindIndexOfByPredicate(Predicate&& predicate) const
+    constexpr int32_t FindIndexOfByPredicate(Predicate&& predicate) const
     {
         return Arrays::FindPredicate(Data, Data + Size, predicate);
     }
 
-    bool Contains(const ElementType& element) const
+    constexpr bool Contains(const ElementType& element) const
     {
         int32_t i = FindIndexOf(element);
         return i != IndexNone;
     }
 
     template <typename Predicate>
-    bool ContainsByPredicate(Predicate&& predicate) const
+    constexpr bool ContainsByPredicate(Predicate&& predicate) const
     {
-        int32_t i = FindIndexOfByPredicate(std::forward<Predicate>(predicate)...);
+        int32_t i = FindIndexOfByPredicate(std::forward<Predicate>(predicate));
         return i != IndexNone;
     }
 
+    template <typename Predicate>
+    constexpr void Sort(Predicate&& predicate)
+    {
+        Arrays::Sort(Data, Data + Size, predicate);
+    }
+
+    /* Small arrays of arithmetic types are sorted with sorting network selected at compile time */
+    constexpr void Sort()
+    {
+        if constexpr (Size <= MaxSortingNetworkSize && TSortingNetworkElement<ElementType>)
+        {
+            TSortingNetwork<Size>::Sort(Data);
+        }
+        else
+        {
+            Sort(std::less<ElementType>{});
+        }
+    }
+
+    /* Array must be sorted by predicate. Returns index of element or IndexNone */
+    template <typename Predicate>
+    constexpr int32_t BinarySearch(const ElementType& element, Predicate&& predicate) const
+    {
+        return Arrays::BinarySearch(Data, Data + Size, element, predicate);
+    }
+
+    constexpr int32_t BinarySearch(const ElementType& element) const
+    {
+        return BinarySearch(element, std::less<ElementType>{});
+    }
+
     template <typename Func>
-    void Generate(Func&& func)
+    constexpr void Generate(Func&& func)
     {
         std::generate(Data, Data + Size, std::forward<Func>(func));
     }
 
-    void Fill(const ElementType& element)
+    constexpr void Fill(const ElementType& element)
     {
         std::fill(Data, Data + Size, element);
     }
@@ -0,0 +1,833 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Array.h"
+#include "Map.h"
+#include "Span.h"
+
+template <typename EntryType, typename LeafType>
+class TBTreeMapIterator
+{
+public:
+    using SelfClass = TBTreeMapIterator<EntryType, LeafType>;
+
+    TBTreeMapIterator(LeafType* leaf, int32_t index) :
+        m_Leaf{leaf},
+        m_Index{index}
+    {
+    }
+
+    TBTreeMapIterator(const SelfClass&) = default;
+    TBTreeMapIterator& operator=(const SelfClass&) = default;
+
+    /* Mutable iterator converts to const one, so they can be compared */
+    template <typename OtherEntryType> requires std::is_same_v<const OtherEntryType, EntryType> && (!std::is_same_v<OtherEntryType, EntryType>)
+    TBTreeMapIterator(const TBTreeMapIterator<OtherEntryType, LeafType>& other) :
+        m_Leaf{other.m_Leaf},
+        m_Index{other.m_Index}
+    {
+    }
+
+    SelfClass& operator++()
+    {
+        if (++m_Index == m_Leaf->NumKeys)
+        {
+            m_Leaf = m_Leaf->Next;
+            m_Index = 0;
+        }
+
+        return *this;
+    }
+
+    SelfClass operator++(int)
+    {
+        SelfClass copy{*this};
+        ++*this;
+        return copy;
+    }
+
+    EntryType& operator*() const
+    {
+        return m_Leaf->Entries[m_Index];
+    }
+
+    EntryType* operator->() const
+    {
+        return &m_Leaf->Entries[m_Index];
+    }
+
+    bool operator==(const SelfClass& other) const
+    {
+        return m_Leaf == other.m_Leaf && m_Index == other.m_Index;
+    }
+
+    bool operator!=(const SelfClass& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    template <typename OtherEntryType, typename OtherLeafType>
+    friend class TBTreeMapIterator;
+
+    LeafType* m_Leaf;
+    int32_t m_Index;
+};
+
+/*
+* B+ tree ordered map. Nodes are sized to NodeSizeBytes (few cache lines), so search touches one node per level
+* and fanout keeps tree shallow. Entries live only in leaves, leaves are linked, so iteration and range scans
+* walk leaves sequentially. Insert and Remove are O(log n), nodes are split, refilled from siblings or merged.
+* Keys and values must be default constructible, unused slots of node hold default constructed objects
+*/
+template <typename KeyType, typename ValueType, typename Predicate = DefaultLessCompare, int32_t NodeSizeBytes = 256>
+class TBTreeMap
+{
+public:
+    using KeyValueType = TKeyValue<KeyType, ValueType>;
+
+private:
+    struct FNode
+    {
+        int32_t NumKeys = 0;
+        bool bLeaf = false;
+    };
+
+    constexpr static int32_t LeafCapacity = std::max<int32_t>(4, (NodeSizeBytes - sizeof(FNode) - sizeof(void*)) / sizeof(KeyValueType));
+    constexpr static int32_t InnerCapacity = std::max<int32_t>(4, (NodeSizeBytes - sizeof(FNode) - sizeof(void*)) / (sizeof(KeyType) + sizeof(void*)));
+
+    constexpr static int32_t MinLeafKeys = LeafCapacity / 2;
+    constexpr static int32_t MinInnerKeys = InnerCapacity / 2;
+
+    /* Arrays have one spare slot, node is split after it overflows */
+    struct FLeafNode : FNode
+    {
+        KeyValueType Entries[LeafCapacity + 1];
+        FLeafNode* Next = nullptr;
+    };
+
+    /* Children[i] holds keys less than Keys[i], Children[i + 1] keys not less than Keys[i] */
+    struct FInnerNode : FNode
+    {
+        KeyType Keys[InnerCapacity + 1];
+        FNode* Children[InnerCapacity + 2];
+    };
+
+public:
+    using Iterator = TBTreeMapIterator<KeyValueType, FLeafNode>;
+    using ConstIterator = TBTreeMapIterator<const KeyValueType, FLeafNode>;
+
+    TBTreeMap() = default;
+
+    TBTreeMap(const TBTreeMap&) = delete;
+    TBTreeMap& operator=(const TBTreeMap&) = delete;
+
+    TBTreeMap(TBTreeMap&& other) noexcept :
+        m_Root{std::exchange(other.m_Root, nullptr)},
+        m_FirstLeaf{std::exchange(other.m_FirstLeaf, nullptr)},
+        m_NumElements{std::exchange(other.m_NumElements, 0)}
+    {
+    }
+
+    TBTreeMap& operator=(TBTreeMap&& other) noexcept
+    {
+        if (&other != this)
+        {
+            Clear();
+            m_Root = std::exchange(other.m_Root, nullptr);
+            m_FirstLeaf = std::exchange(other.m_FirstLeaf, nullptr);
+            m_NumElements = std::exchange(other.m_NumElements, 0);
+        }
+
+        return *this;
+    }
+
+    ~TBTreeMap() noexcept
+    {
+        Clear();
+    }
+
+    void Insert(const KeyType& key, const ValueType& value)
+    {
+        Emplace(key, value);
+    }
+
+    /* Existing value of the key is replaced */
+    template <typename ...Args>
+    void Emplace(const KeyType& key, Args&& ...args)
+    {
+        if (!m_Root)
+        {
+            m_FirstLeaf = new FLeafNode{};
+            m_FirstLeaf->bLeaf = true;
+            m_Root = m_FirstLeaf;
+        }
+
+        FSplit split = InsertRecursive(m_Root, key, std::forward<Args>(args)...);
+
+        if (split.Right)
+        {
+            FInnerNode* root = new FInnerNode{};
+            root->NumKeys = 1;
+            root->Keys[0] = std::move(split.Separator);
+            root->Children[0] = m_Root;
+            root->Children[1] = split.Right;
+            m_Root = root;
+        }
+    }
+
+    /*
+    * Builds tree bottom-up from all existing and given entries, with leaves and inner nodes filled evenly.
+    * Later pairs overwrite values of earlier ones with the same key, input doesn't have to be sorted
+    */
+    void BulkLoad(TSpan<const KeyValueType> keyValues)
+    {
+        TArray<KeyValueType> entries;
+        entries.AllocAbs(m_NumElements + keyValues.GetNumElements());
+
+        for (KeyValueType& entry : *this)
+        {
+            entries.Add(std::move(entry));
+        }
+
+        entries.Append(keyValues.GetData(), keyValues.GetNumElements());
+        Clear();
+
+        Predicate pred{};
+
+        /* Stable, so the last of equal keys is the latest one */
+        entries.StableSort([&pred](const KeyValueType& a, const KeyValueType& b)
+        {
+            return pred(a.Key, b.Key);
+        });
+
+        int32_t numUnique = 0;
+
+        for (int32_t i = 0; i < entries.GetNumElements(); ++i)
+        {
+            if (i + 1 < entries.GetNumElements() && !pred(entries[i].Key, entries[i + 1].Key))
+            {
+                continue;
+            }
+
+            if (numUnique != i)
+            {
+                entries[numUnique] = std::move(entries[i]);
+            }
+
+            numUnique++;
+        }
+
+        BuildFromSorted(entries.GetData(), numUnique);
+    }
+
+    ValueType* Find(const KeyType& key)
+    {
+        KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    const ValueType* Find(const KeyType& key) const
+    {
+        const KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    ValueType* Find(const LookupKeyType& key)
+    {
+        KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    const ValueType* Find(const LookupKeyType& key) const
+    {
+        const KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return FindEntry(key) != nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return FindEntry(key) != nullptr;
+    }
+
+    const ValueType& operator[](const KeyType& key) const
+    {
+        auto it = Find(key);
+        CHECK_ITEM_EXISTS(it);
+        return *it;
+    }
+
+    ValueType& operator[](const KeyType& key)
+    {
+        auto it = Find(key);
+        CHECK_ITEM_EXISTS(it);
+        return *it;
+    }
+
+    void Remove(const KeyType& key)
+    {
+        if (!m_Root || !RemoveRecursive(m_Root, key))
+        {
+            return;
+        }
+
+        /* Shrink tree height, when root lost its last separator */
+        if (!m_Root->bLeaf && m_Root->NumKeys == 0)
+        {
+            FInnerNode* root = static_cast<FInnerNode*>(m_Root);
+            m_Root = root->Children[0];
+            delete root;
+        }
+        else if (m_Root->bLeaf && m_Root->NumKeys == 0)
+        {
+            delete static_cast<FLeafNode*>(m_Root);
+            m_Root = nullptr;
+            m_FirstLeaf = nullptr;
+        }
+    }
+
+    /* First entry with key not less than given key, or end() */
+    Iterator LowerBound(const KeyType& key)
+    {
+        return FindBound<false, Iterator>(key);
+    }
+
+    ConstIterator LowerBound(const KeyType& key) const
+    {
+        return FindBound<false, ConstIterator>(key);
+    }
+
+    /* First entry with key greater than given key, or end() */
+    Iterator UpperBound(const KeyType& key)
+    {
+        return FindBound<true, Iterator>(key);
+    }
+
+    ConstIterator UpperBound(const KeyType& key) const
+    {
+        return FindBound<true, ConstIterator>(key);
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_NumElements;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_NumElements == 0;
+    }
+
+    TArray<KeyType> GetKeys() const
+    {
+        TArray<KeyType> keys;
+        keys.AllocAbs(m_NumElements);
+
+        for (const KeyValueType& entry : *this)
+        {
+            keys.Add(entry.Key);
+        }
+
+        return keys;
+    }
+
+    void Clear()
+    {
+        if (m_Root)
+        {
+            DeleteNode(m_Root);
+        }
+
+        m_Root = nullptr;
+        m_FirstLeaf = nullptr;
+        m_NumElements = 0;
+    }
+
+    Iterator begin()
+    {
+        return Iterator{m_FirstLeaf, 0};
+    }
+
+    Iterator end()
+    {
+        return Iterator{nullptr, 0};
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator{m_FirstLeaf, 0};
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator{nullptr, 0};
+    }
+
+private:
+    /* Result of inserting into subtree, Right is set, when subtree root was split */
+    struct FSplit
+    {
+        KeyType Separator{};
+        FNode* Right = nullptr;
+    };
+
+    FNode* m_Root = nullptr;
+    FLeafNode* m_FirstLeaf = nullptr;
+    int32_t m_NumElements = 0;
+
+private:
+    /* Index of child, which contains key */
+    template <typename LookupKeyType>
+    static int32_t FindChildIndex(const FInnerNode* node, const LookupKeyType& key)
+    {
+        const KeyType* it = Arrays::UpperBound(node->Keys, node->Keys + node->NumKeys, key, [](const LookupKeyType& a, const KeyType& b)
+        {
+            return Predicate{}(a, b);
+        });
+
+        return static_cast<int32_t>(it - node->Keys);
+    }
+
+    /* Index of first entry not less than key */
+    template <typename LookupKeyType>
+    static int32_t FindEntryIndex(const FLeafNode* leaf, const LookupKeyType& key)
+    {
+        const KeyValueType* it = Arrays::LowerBound(leaf->Entries, leaf->Entries + leaf->NumKeys, key,
+            [](const KeyValueType& a, const LookupKeyType& b)
+        {
+            return Predicate{}(a.Key, b);
+        });
+
+        return static_cast<int32_t>(it - leaf->Entries);
+    }
+
+    template <typename LookupKeyType>
+    FLeafNode* FindLeaf(const LookupKeyType& key) const
+    {
+        FNode* node = m_Root;
+
+        while (node && !node->bLeaf)
+        {
+            FInnerNode* inner = static_cast<FInnerNode*>(node);
+            node = inner->Children[FindChildIndex(inner, key)];
+        }
+
+        return static_cast<FLeafNode*>(node);
+    }
+
+    template <typename LookupKeyType>
+    KeyValueType* FindEntry(const LookupKeyType& key) const
+    {
+        FLeafNode* leaf = FindLeaf(key);
+
+        if (!leaf)
+        {
+            return nullptr;
+        }
+
+        int32_t index = FindEntryIndex(leaf, key);
+        return index < leaf->NumKeys && !Predicate{}(key, leaf->Entries[index].Key) ? &leaf->Entries[index] : nullptr;
+    }
+
+    /* Index of first element with key greater than (bUpper) or not less than key, in sorted elements */
+    template <bool bUpper, typename ElementType, typename GetKeyFunc>
+    static int32_t FindBoundIndex(const ElementType* elements, int32_t numElements, const KeyType& key, GetKeyFunc&& getKey)
+    {
+        const ElementType* it;
+
+        if constexpr (bUpper)
+        {
+            it = Arrays::UpperBound(elements, elements + numElements, key, [&getKey](const KeyType& a, const ElementType& b)
+            {
+                return Predicate{}(a, getKey(b));
+            });
+        }
+        else
+        {
+            it = Arrays::LowerBound(elements, elements + numElements, key, [&getKey](const ElementType& a, const KeyType& b)
+            {
+                return Predicate{}(getKey(a), b);
+            });
+        }
+
+        return static_cast<int32_t>(it - elements);
+    }
+
+    /* Descends with the same bound as in leaf, so separator equal to key leads to the subtree, where bound can start */
+    template <bool bUpper, typename IteratorType>
+    IteratorType FindBound(const KeyType& key) const
+    {
+        FNode* node = m_Root;
+
+        if (!node)
+        {
+            return IteratorType{nullptr, 0};
+        }
+
+        while (!node->bLeaf)
+        {
+            FInnerNode* inner = static_cast<FInnerNode*>(node);
+            node = inner->Children[FindBoundIndex<bUpper>(inner->Keys, inner->NumKeys, key, [](const KeyType& separator) -> const KeyType&
+            {
+                return separator;
+            })];
+        }
+
+        FLeafNode* leaf = static_cast<FLeafNode*>(node);
+        int32_t index = FindBoundIndex<bUpper>(leaf->Entries, leaf->NumKeys, key, [](const KeyValueType& entry) -> const KeyType&
+        {
+            return entry.Key;
+        });
+
+        /* Bound is the first entry of the next leaf */
+        if (index == leaf->NumKeys)
+        {
+            return IteratorType{leaf->Next, 0};
+        }
+
+        return IteratorType{leaf, index};
+    }
+
+    template <typename ...Args>
+    FSplit InsertRecursive(FNode* node, const KeyType& key, Args&& ...args)
+    {
+        if (node->bLeaf)
+        {
+            FLeafNode* leaf = static_cast<FLeafNode*>(node);
+            int32_t index = FindEntryIndex(leaf, key);
+
+            if (index < leaf->NumKeys && !Predicate{}(key, leaf->Entries[index].Key))
+            {
+                leaf->Entries[index].Value = ValueType(std::forward<Args>(args)...);
+                return FSplit{};
+            }
+
+            std::move_backward(leaf->Entries + index, leaf->Entries + leaf->NumKeys, leaf->Entries + leaf->NumKeys + 1);
+            leaf->Entries[index] = KeyValueType(key, std::forward<Args>(args)...);
+            leaf->NumKeys++;
+            m_NumElements++;
+
+            return leaf->NumKeys > LeafCapacity ? SplitLeaf(leaf) : FSplit{};
+        }
+
+        FInnerNode* inner = static_cast<FInnerNode*>(node);
+        int32_t childIndex = FindChildIndex(inner, key);
+        FSplit childSplit = InsertRecursive(inner->Children[childIndex], key, std::forward<Args>(args)...);
+
+        if (!childSplit.Right)
+        {
+            return FSplit{};
+        }
+
+        std::move_backward(inner->Keys + childIndex, inner->Keys + inner->NumKeys, inner->Keys + inner->NumKeys + 1);
+        std::move_backward(inner->Children + childIndex + 1, inner->Children + inner->NumKeys + 1, inner->Children + inner->NumKeys + 2);
+        inner->Keys[childIndex] = std::move(childSplit.Separator);
+        inner->Children[childIndex + 1] = childSplit.Right;
+        inner->NumKeys++;
+
+        return inner->NumKeys > InnerCapacity ? SplitInner(inner) : FSplit{};
+    }
+
+    FSplit SplitLeaf(FLeafNode* leaf)
+    {
+        FLeafNode* right = new FLeafNode{};
+        right->bLeaf = true;
+
+        int32_t numLeft = leaf->NumKeys / 2;
+        right->NumKeys = leaf->NumKeys - numLeft;
+        std::move(leaf->Entries + numLeft, leaf->Entries + leaf->NumKeys, right->Entries);
+        leaf->NumKeys = numLeft;
+
+        right->Next = leaf->Next;
+        leaf->Next = right;
+
+        return FSplit{right->Entries[0].Key, right};
+    }
+
+    /* Middle separator moves up to parent */
+    FSplit SplitInner(FInnerNode* inner)
+    {
+        FInnerNode* right = new FInnerNode{};
+
+        int32_t middle = inner->NumKeys / 2;
+        right->NumKeys = inner->NumKeys - middle - 1;
+        std::move(inner->Keys + middle + 1, inner->Keys + inner->NumKeys, right->Keys);
+        std::copy(inner->Children + middle + 1, inner->Children + inner->NumKeys + 1, right->Children);
+        inner->NumKeys = middle;
+
+        return FSplit{std::move(inner->Keys[middle]), right};
+    }
+
+    bool RemoveRecursive(FNode* node, const KeyType& key)
+    {
+        if (node->bLeaf)
+        {
+            FLeafNode* leaf = static_cast<FLeafNode*>(node);
+            int32_t index = FindEntryIndex(leaf, key);
+
+            if (index == leaf->NumKeys || Predicate{}(key, leaf->Entries[index].Key))
+            {
+                return false;
+            }
+
+            std::move(leaf->Entries + index + 1, leaf->Entries + leaf->NumKeys, leaf->Entries + index);
+            leaf->NumKeys--;
+            leaf->Entries[leaf->NumKeys] = KeyValueType{};
+            m_NumElements--;
+
+            return true;
+        }
+
+        FInnerNode* inner = static_cast<FInnerNode*>(node);
+        int32_t childIndex = FindChildIndex(inner, key);
+        FNode* child = inner->Children[childIndex];
+
+        if (!RemoveRecursive(child, key))
+        {
+            return false;
+        }
+
+        if (child->NumKeys < (child->bLeaf ? MinLeafKeys : MinInnerKeys))
+        {
+            Rebalance(inner, childIndex);
+        }
+
+        return true;
+    }
+
+    /* Refills underflowed child from sibling with spare keys, or merges it with sibling */
+    void Rebalance(FInnerNode* parent, int32_t childIndex)
+    {
+        FNode* left = childIndex > 0 ? parent->Children[childIndex - 1] : nullptr;
+        FNode* right = childIndex < parent->NumKeys ? parent->Children[childIndex + 1] : nullptr;
+        int32_t minKeys = parent->Children[childIndex]->bLeaf ? MinLeafKeys : MinInnerKeys;
+
+        if (left && left->NumKeys > minKeys)
+        {
+            BorrowFromLeft(parent, childIndex);
+        }
+        else if (right && right->NumKeys > minKeys)
+        {
+            BorrowFromRight(parent, childIndex);
+        }
+        else if (left)
+        {
+            Merge(parent, childIndex - 1);
+        }
+        else
+        {
+            Merge(parent, childIndex);
+        }
+    }
+
+    void BorrowFromLeft(FInnerNode* parent, int32_t childIndex)
+    {
+        FNode* childNode = parent->Children[childIndex];
+        FNode* leftNode = parent->Children[childIndex - 1];
+
+        if (childNode->bLeaf)
+        {
+            FLeafNode* child = static_cast<FLeafNode*>(childNode);
+            FLeafNode* left = static_cast<FLeafNode*>(leftNode);
+
+            std::move_backward(child->Entries, child->Entries + child->NumKeys, child->Entries + child->NumKeys + 1);
+            child->Entries[0] = std::move(left->Entries[left->NumKeys - 1]);
+            child->NumKeys++;
+            left->NumKeys--;
+
+            parent->Keys[childIndex - 1] = child->Entries[0].Key;
+        }
+        else
+        {
+            FInnerNode* child = static_cast<FInnerNode*>(childNode);
+            FInnerNode* left = static_cast<FInnerNode*>(leftNode);
+
+            std::move_backward(child->Keys, child->Keys + child->NumKeys, child->Keys + child->NumKeys + 1);
+            std::move_backward(child->Children, child->Children + child->NumKeys + 1, child->Children + child->NumKeys + 2);
+            child->Keys[0] = std::move(parent->Keys[childIndex - 1]);
+            child->Children[0] = left->Children[left->NumKeys];
+            child->NumKeys++;
+
+            parent->Keys[childIndex - 1] = std::move(left->Keys[left->NumKeys - 1]);
+            left->NumKeys--;
+        }
+    }
+
+    void BorrowFromRight(FInnerNode* parent, int32_t childIndex)
+    {
+        FNode* childNode = parent->Children[childIndex];
+        FNode* rightNode = parent->Children[childIndex + 1];
+
+        if (childNode->bLeaf)
+        {
+            FLeafNode* child = static_cast<FLeafNode*>(childNode);
+            FLeafNode* right = static_cast<FLeafNode*>(rightNode);
+
+            child->Entries[child->NumKeys] = std::move(right->Entries[0]);
+            child->NumKeys++;
+
+            std::move(right->Entries + 1, right->Entries + right->NumKeys, right->Entries);
+            right->NumKeys--;
+
+            parent->Keys[childIndex] = right->Entries[0].Key;
+        }
+        else
+        {
+            FInnerNode* child = static_cast<FInnerNode*>(childNode);
+            FInnerNode* right = static_cast<FInnerNode*>(rightNode);
+
+            child->Keys[child->NumKeys] = std::move(parent->Keys[childIndex]);
+            child->Children[child->NumKeys + 1] = right->Children[0];
+            child->NumKeys++;
+
+            parent->Keys[childIndex] = std::move(right->Keys[0]);
+            std::move(right->Keys + 1, right->Keys + right->NumKeys, right->Keys);
+            std::copy(right->Children + 1, right->Children + right->NumKeys + 1, right->Children);
+            right->NumKeys--;
+        }
+    }
+
+    /* Merges Children[leftIndex + 1] into Children[leftIndex] and removes separator between them */
+    void Merge(FInnerNode* parent, int32_t leftIndex)
+    {
+        FNode* leftNode = parent->Children[leftIndex];
+        FNode* rightNode = parent->Children[leftIndex + 1];
+
+        if (leftNode->bLeaf)
+        {
+            FLeafNode* left = static_cast<FLeafNode*>(leftNode);
+            FLeafNode* right = static_cast<FLeafNode*>(rightNode);
+
+            std::move(right->Entries, right->Entries + right->NumKeys, left->Entries + left->NumKeys);
+            left->NumKeys += right->NumKeys;
+            left->Next = right->Next;
+
+            delete right;
+        }
+        else
+        {
+            FInnerNode* left = static_cast<FInnerNode*>(leftNode);
+            FInnerNode* right = static_cast<FInnerNode*>(rightNode);
+
+            left->Keys[left->NumKeys] = std::move(parent->Keys[leftIndex]);
+            std::move(right->Keys, right->Keys + right->NumKeys, left->Keys + left->NumKeys + 1);
+            std::copy(right->Children, right->Children + right->NumKeys + 1, left->Children + left->NumKeys + 1);
+            left->NumKeys += right->NumKeys + 1;
+
+            delete right;
+        }
+
+        std::move(parent->Keys + leftIndex + 1, parent->Keys + parent->NumKeys, parent->Keys + leftIndex);
+        std::copy(parent->Children + leftIndex + 2, parent->Children + parent->NumKeys + 1, parent->Children + leftIndex + 1);
+        parent->NumKeys--;
+    }
+
+    void BuildFromSorted(KeyValueType* entries, int32_t numEntries)
+    {
+        if (numEntries == 0)
+        {
+            return;
+        }
+
+        /* Current level nodes and smallest key in each of their subtrees */
+        TArray<FNode*> level;
+        TArray<KeyType> levelKeys;
+
+        int32_t numLeaves = (numEntries + LeafCapacity - 1) / LeafCapacity;
+        FLeafNode* previous = nullptr;
+
+        for (int32_t i = 0; i < numLeaves; ++i)
+        {
+            /* Spread entries evenly, so the last leaf isn't underfilled */
+            int32_t begin = static_cast<int32_t>(static_cast<int64_t>(numEntries) * i / numLeaves);
+            int32_t end = static_cast<int32_t>(static_cast<int64_t>(numEntries) * (i + 1) / numLeaves);
+
+            FLeafNode* leaf = new FLeafNode{};
+            leaf->bLeaf = true;
+            leaf->NumKeys = end - begin;
+            std::move(entries + begin, entries + end, leaf->Entries);
+
+            if (previous)
+            {
+                previous->Next = leaf;
+            }
+            else
+            {
+                m_FirstLeaf = leaf;
+            }
+
+            previous = leaf;
+            level.Add(leaf);
+            levelKeys.Add(leaf->Entries[0].Key);
+        }
+
+        while (level.GetNumElements() > 1)
+        {
+            TArray<FNode*> parents;
+            TArray<KeyType> parentKeys;
+
+            int32_t numChildren = level.GetNumElements();
+            int32_t numParents = (numChildren + InnerCapacity) / (InnerCapacity + 1);
+
+            for (int32_t i = 0; i < numParents; ++i)
+            {
+                int32_t begin = static_cast<int32_t>(static_cast<int64_t>(numChildren) * i / numParents);
+                int32_t end = static_cast<int32_t>(static_cast<int64_t>(numChildren) * (i + 1) / numParents);
+
+                FInnerNode* inner = new FInnerNode{};
+                inner->NumKeys = end - begin - 1;
+
+                for (int32_t j = begin; j < end; ++j)
+                {
+                    inner->Children[j - begin] = level[j];
+
+                    if (j > begin)
+                    {
+                        inner->Keys[j - begin - 1] = levelKeys[j];
+                    }
+                }
+
+                parents.Add(inner);
+                parentKeys.Add(levelKeys[begin]);
+            }
+
+            level.swap(parents);
+            levelKeys.swap(parentKeys);
+        }
+
+        m_Root = level[0];
+        m_NumElements = numEntries;
+    }
+
+    static void DeleteNode(FNode* node)
+    {
+        if (node->bLeaf)
+        {
+            delete static_cast<FLeafNode*>(node);
+            return;
+        }
+
+        FInnerNode* inner = static_cast<FInnerNode*>(node);
+
+        for (int32_t i = 0; i <= inner->NumKeys; ++i)
+        {
+            DeleteNode(inner->Children[i]);
+        }
+
+        delete inner;
+    }
+};
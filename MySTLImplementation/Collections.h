@@ -2,12 +2,29 @@
 
 #include "Array.h"
 #include "BstTree.h"
+#include "BTreeMap.h"
+#include "ConcurrentMap.h"
 #include "EnumAsByte.h"
+#include "FixedCapacityArray.h"
 #include "FixedString.h"
+#include "FrozenMap.h"
+#include "Hash.h"
+#include "HashedString.h"
+#include "HashTableStats.h"
 #include "List.h"
+#include "LruCache.h"
 #include "Map.h"
+#include "MappedFile.h"
+#include "MappedMap.h"
+#include "MultiMap.h"
 #include "Optional.h"
+#include "Set.h"
+#include "ShardedAggregator.h"
 #include "SharedPtr.h"
+#include "SnapshotMap.h"
+#include "SortingNetwork.h"
+#include "StaticMap.h"
 #include "Span.h"
 #include "String.h"
+#include "SwissMap.h"
 #include "UniquePtr.h"
\ No newline at end of file
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+#include "Map.h"
+#include "Optional.h"
+
+/*
+* Hash map, which can be shared between threads. Keys are distributed over NumShards independent TMaps,
+* each guarded by its own reader-writer lock, so threads working on different shards never wait for each other
+* and readers of the same shard run in parallel. Values are returned by copy or accessed through callbacks
+* invoked under the lock, references never escape the lock
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator, int32_t NumShards = 64>
+class TConcurrentMap
+{
+    static_assert(NumShards > 0 && (NumShards & (NumShards - 1)) == 0, "NumShards must be power of two");
+
+public:
+    using MapType = TMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType>;
+    using KeyValueType = typename MapType::KeyValueType;
+
+    TConcurrentMap() = default;
+
+    TConcurrentMap(const TConcurrentMap&) = delete;
+    TConcurrentMap& operator=(const TConcurrentMap&) = delete;
+
+    void Insert(const KeyType& key, const ValueType& value)
+    {
+        FShard& shard = GetShard(key);
+        std::unique_lock lock{shard.Mutex};
+        shard.Map.Insert(key, value);
+    }
+
+    void Remove(const KeyType& key)
+    {
+        FShard& shard = GetShard(key);
+        std::unique_lock lock{shard.Mutex};
+        shard.Map.Remove(key);
+    }
+
+    /* Returns copy of value, because entry may be changed or removed by other thread right after lock is released */
+    TOptional<ValueType> Find(const KeyType& key) const
+    {
+        const FShard& shard = GetShard(key);
+        std::shared_lock lock{shard.Mutex};
+
+        const ValueType* value = shard.Map.FindValue(key);
+        return value ? TOptional<ValueType>{*value} : TOptional<ValueType>{NullOpt};
+    }
+
+    /* Calls func(const ValueType&) under shared lock, if key exists. Returns false when key wasn't found */
+    template <typename FuncType>
+    bool Read(const KeyType& key, FuncType&& func) const
+    {
+        const FShard& shard = GetShard(key);
+        std::shared_lock lock{shard.Mutex};
+
+        const ValueType* value = shard.Map.FindValue(key);
+
+        if (value)
+        {
+            func(*value);
+        }
+
+        return value != nullptr;
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        const FShard& shard = GetShard(key);
+        std::shared_lock lock{shard.Mutex};
+        return shard.Map.Contains(key);
+    }
+
+    /* Returns current value of key. If key doesn't exist, defaultValue is inserted and returned */
+    ValueType FindOrAdd(const KeyType& key, const ValueType& defaultValue)
+    {
+        FShard& shard = GetShard(key);
+
+        {
+            std::shared_lock lock{shard.Mutex};
+            const ValueType* value = shard.Map.FindValue(key);
+
+            if (value)
+            {
+                return *value;
+            }
+        }
+
+        std::unique_lock lock{shard.Mutex};
+
+        /* Other thread could insert the key between releasing shared lock and acquiring exclusive one */
+        const ValueType* value = shard.Map.FindValue(key);
+
+        if (value)
+        {
+            return *value;
+        }
+
+        shard.Map.Insert(key, defaultValue);
+        return defaultValue;
+    }
+
+    /*
+    * Atomically modifies value with func(ValueType&). Missing key is inserted with default constructed value first,
+    * so read-modify-write patterns like counters need single call
+    */
+    template <typename FuncType>
+    void Update(const KeyType& key, FuncType&& func)
+    {
+        FShard& shard = GetShard(key);
+        std::unique_lock lock{shard.Mutex};
+
+        ValueType* value = shard.Map.FindValue(key);
+
+        if (!value)
+        {
+            shard.Map.Insert(key, ValueType{});
+            value = shard.Map.FindValue(key);
+        }
+
+        func(*value);
+    }
+
+    /* Modifies value with func(ValueType&) only if key exists. Returns false when key wasn't found */
+    template <typename FuncType>
+    bool UpdateIfExists(const KeyType& key, FuncType&& func)
+    {
+        FShard& shard = GetShard(key);
+        std::unique_lock lock{shard.Mutex};
+
+        ValueType* value = shard.Map.FindValue(key);
+
+        if (value)
+        {
+            func(*value);
+        }
+
+        return value != nullptr;
+    }
+
+    /* Visits all entries with func(const KeyValueType&). Each shard is locked separately, so result isn't global snapshot */
+    template <typename FuncType>
+    void ForEach(FuncType&& func) const
+    {
+        for (const FShard& shard : m_Shards)
+        {
+            std::shared_lock lock{shard.Mutex};
+
+            for (const KeyValueType& keyValue : shard.Map)
+            {
+                func(keyValue);
+            }
+        }
+    }
+
+    int32_t GetNumElements() const
+    {
+        int32_t numElements = 0;
+
+        for (const FShard& shard : m_Shards)
+        {
+            std::shared_lock lock{shard.Mutex};
+            numElements += shard.Map.GetNumElements();
+        }
+
+        return numElements;
+    }
+
+    void Clear()
+    {
+        for (FShard& shard : m_Shards)
+        {
+            std::unique_lock lock{shard.Mutex};
+            shard.Map.Clear();
+        }
+    }
+
+private:
+    /* Each shard in its own cache line, so locking one shard doesn't invalidate line of neighbour */
+    struct alignas(64) FShard
+    {
+        mutable std::shared_mutex Mutex;
+        MapType Map;
+    };
+
+    FShard m_Shards[NumShards];
+    HashFunction m_HashFunction;
+
+private:
+    /* Fibonacci hashing spreads top bits, so shard doesn't correlate with slot inside shard's map */
+    int32_t GetShardIndex(const KeyType& key) const
+    {
+        uint64_t hash = m_HashFunction(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<int32_t>(hash >> 32) & (NumShards - 1);
+    }
+
+    FShard& GetShard(const KeyType& key)
+    {
+        return m_Shards[GetShardIndex(key)];
+    }
+
+    const FShard& GetShard(const KeyType& key) const
+    {
+        return m_Shards[GetShardIndex(key)];
+    }
+};
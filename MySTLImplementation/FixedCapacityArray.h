@@ -0,0 +1,414 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <initializer_list>
+
+#include "Array.h"
+
+/*
+* Array with runtime number of elements and compile time capacity.
+* Elements live inside the object, so it never touches the heap.
+* Use it for scratch buffers, where upper bound of elements is known up front
+*/
+template <typename ElementType, int32_t Capacity>
+class TFixedCapacityArray
+{
+    static_assert(Capacity > 0, "Capacity must be greater than zero");
+
+public:
+    using ValueType = ElementType;
+    using ConstValueType = const ElementType;
+    using SelfClass = TFixedCapacityArray<ElementType, Capacity>;
+
+    using Iterator = TArrayIterator<SelfClass, ValueType>;
+    using ConstIterator = TArrayIterator<const SelfClass, ConstValueType>;
+
+    TFixedCapacityArray() :
+        m_NumElements{0}
+    {
+    }
+
+    TFixedCapacityArray(std::initializer_list<ElementType> elements) :
+        m_NumElements{0}
+    {
+        Append(elements);
+    }
+
+    TFixedCapacityArray(const SelfClass& elements) :
+        m_NumElements{0}
+    {
+        Append(elements.GetData(), elements.GetNumElements());
+    }
+
+    TFixedCapacityArray& operator=(const SelfClass& elements)
+    {
+        if (&elements != this)
+        {
+            Empty();
+            Append(elements.GetData(), elements.GetNumElements());
+        }
+
+        return *this;
+    }
+
+    TFixedCapacityArray(SelfClass&& elements) noexcept :
+        m_NumElements{0}
+    {
+        MoveFrom(elements);
+    }
+
+    TFixedCapacityArray& operator=(SelfClass&& elements) noexcept
+    {
+        if (&elements != this)
+        {
+            Empty();
+            MoveFrom(elements);
+        }
+
+        return *this;
+    }
+
+    ~TFixedCapacityArray() noexcept
+    {
+        Empty();
+    }
+
+public:
+    template <typename ...Args>
+    void EmplaceBack(Args&& ...args)
+    {
+        assert(!IsFull() && "TFixedCapacityArray capacity exceeded");
+
+        new (GetData() + m_NumElements) ElementType(std::forward<Args>(args)...);
+        m_NumElements++;
+    }
+
+    template <typename ...Args>
+    void EmplaceAt(int32_t index, Args&& ...args)
+    {
+        assert(index >= 0 && index <= m_NumElements);
+
+        if (index == m_NumElements)
+        {
+            EmplaceBack(std::forward<Args>(args)...);
+            return;
+        }
+
+        ElementType element(std::forward<Args>(args)...);
+        ElementType* data = GetData();
+
+        EmplaceBack(std::move(data[m_NumElements - 1]));
+        std::move_backward(data + index, data + m_NumElements - 2, data + m_NumElements - 1);
+        data[index] = std::move(element);
+    }
+
+    void PushBack(const ElementType& element)
+    {
+        EmplaceBack(element);
+    }
+
+    void PushBack(ElementType&& element)
+    {
+        EmplaceBack(std::move(element));
+    }
+
+    int32_t Add(const ElementType& element)
+    {
+        EmplaceBack(element);
+        return m_NumElements - 1;
+    }
+
+    int32_t Add(ElementType&& element)
+    {
+        EmplaceBack(std::move(element));
+        return m_NumElements - 1;
+    }
+
+    int32_t AddUnique(const ElementType& element)
+    {
+        int32_t i = FindIndexOf(element);
+
+        if (i == IndexNone)
+        {
+            return Add(element);
+        }
+
+        return i;
+    }
+
+    void Append(std::initializer_list<ElementType> elements)
+    {
+        Append(elements.begin(), (int32_t)elements.size());
+    }
+
+    void Append(const ElementType* data, int32_t size)
+    {
+        AllocAbs(m_NumElements + size);
+
+        for (int32_t i = 0; i < size; ++i)
+        {
+            Add(data[i]);
+        }
+    }
+
+    /* Storage can't grow, only checks that requested number of elements fits */
+    void AllocAbs(int32_t abs) const
+    {
+        assert(abs <= Capacity && "TFixedCapacityArray capacity exceeded");
+    }
+
+    void PopBack()
+    {
+        assert(m_NumElements > 0);
+
+        m_NumElements--;
+        GetData()[m_NumElements].~ElementType();
+    }
+
+    void RemoveIndex(int32_t index)
+    {
+        assert(IsValidIndex(index));
+
+        ElementType* data = GetData();
+        std::move(data + index + 1, data + m_NumElements, data + index);
+        PopBack();
+    }
+
+    /* Removes element in O(1) by moving last element into its place. Doesn't preserve order */
+    void RemoveIndexSwap(int32_t index)
+    {
+        assert(IsValidIndex(index));
+
+        ElementType* data = GetData();
+
+        if (index != m_NumElements - 1)
+        {
+            data[index] = std::move(data[m_NumElements - 1]);
+        }
+
+        PopBack();
+    }
+
+    void Remove(const ElementType& element)
+    {
+        int32_t i = FindIndexOf(element);
+
+        if (i != IndexNone)
+        {
+            RemoveIndex(i);
+        }
+    }
+
+    void Empty()
+    {
+        std::destroy(GetData(), GetData() + m_NumElements);
+        m_NumElements = 0;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_NumElements;
+    }
+
+    constexpr int32_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    intptr_t GetSizeBytes() const
+    {
+        return static_cast<intptr_t>(m_NumElements) * sizeof(ElementType);
+    }
+
+    bool IsEmpty() const
+    {
+        return m_NumElements == 0;
+    }
+
+    bool IsFull() const
+    {
+        return m_NumElements == Capacity;
+    }
+
+    bool IsValidIndex(int32_t index) const
+    {
+        return index >= 0 && index < m_NumElements;
+    }
+
+    int32_t FindIndexOf(const ElementType& element) const
+    {
+        return Arrays::Find(GetData(), GetData() + m_NumElements, element);
+    }
+
+    template <std::predicate<const ElementType> Predicate>
+    int32_t FindIndexOfByPredicate(Predicate&& predicate) const
+    {
+        return Arrays::FindPredicate(GetData(), GetData() + m_NumElements, predicate);
+    }
+
+    bool Contains(const ElementType& element) const
+    {
+        return FindIndexOf(element) != IndexNone;
+    }
+
+    template <typename Predicate>
+    bool ContainsByPredicate(Predicate&& predicate) const
+    {
+        return FindIndexOfByPredicate(std::forward<Predicate>(predicate)) != IndexNone;
+    }
+
+    ElementType* GetData()
+    {
+        return reinterpret_cast<ElementType*>(m_Storage);
+    }
+
+    const ElementType* GetData() const
+    {
+        return reinterpret_cast<const ElementType*>(m_Storage);
+    }
+
+    ElementType& operator[](int32_t index)
+    {
+        assert(IsValidIndex(index));
+        return GetData()[index];
+    }
+
+    const ElementType& operator[](int32_t index) const
+    {
+        assert(IsValidIndex(index));
+        return GetData()[index];
+    }
+
+    ElementType& Back()
+    {
+        assert(m_NumElements > 0);
+        return GetData()[m_NumElements - 1];
+    }
+
+    const ElementType& Back() const
+    {
+        assert(m_NumElements > 0);
+        return GetData()[m_NumElements - 1];
+    }
+
+    ElementType& Front()
+    {
+        assert(m_NumElements > 0);
+        return GetData()[0];
+    }
+
+    const ElementType& Front() const
+    {
+        assert(m_NumElements > 0);
+        return GetData()[0];
+    }
+
+    template <typename Predicate>
+    void Sort(Predicate&& predicate)
+    {
+        Arrays::Sort(GetData(), GetData() + m_NumElements, predicate);
+    }
+
+    void Sort()
+    {
+        Sort(std::less<ElementType>{});
+    }
+
+    template <typename Predicate>
+    void SortUnique(Predicate&& predicate)
+    {
+        ElementType* newEnd = Arrays::SortUnique(GetData(), GetData() + m_NumElements, predicate);
+        TruncateTo(static_cast<int32_t>(newEnd - GetData()));
+    }
+
+    void SortUnique()
+    {
+        SortUnique(std::less<ElementType>{});
+    }
+
+    template <typename Func>
+    void Generate(Func&& func)
+    {
+        std::generate(GetData(), GetData() + m_NumElements, std::forward<Func>(func));
+    }
+
+    void Fill(const ElementType& element)
+    {
+        std::fill(GetData(), GetData() + m_NumElements, element);
+    }
+
+    Iterator begin()
+    {
+        return Iterator{*this, 0};
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator{*this, 0};
+    }
+
+    Iterator end()
+    {
+        return Iterator{*this, m_NumElements};
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator{*this, m_NumElements};
+    }
+
+    ElementType* UncheckedBegin()
+    {
+        return GetData();
+    }
+
+    const ElementType* UncheckedBegin() const
+    {
+        return GetData();
+    }
+
+    ElementType* UncheckedEnd()
+    {
+        return GetData() + m_NumElements;
+    }
+
+    const ElementType* UncheckedEnd() const
+    {
+        return GetData() + m_NumElements;
+    }
+
+    operator TSpan<ElementType>()
+    {
+        return TSpan<ElementType>{GetData(), m_NumElements};
+    }
+
+    operator TSpan<const ElementType>() const
+    {
+        return TSpan<const ElementType>{GetData(), m_NumElements};
+    }
+
+private:
+    alignas(ElementType) uint8_t m_Storage[Capacity * sizeof(ElementType)];
+    int32_t m_NumElements;
+
+private:
+    void MoveFrom(SelfClass& elements)
+    {
+        for (int32_t i = 0; i < elements.m_NumElements; ++i)
+        {
+            EmplaceBack(std::move(elements.GetData()[i]));
+        }
+
+        elements.Empty();
+    }
+
+    void TruncateTo(int32_t numElements)
+    {
+        assert(numElements >= 0 && numElements <= m_NumElements);
+
+        std::destroy(GetData() + numElements, GetData() + m_NumElements);
+        m_NumElements = numElements;
+    }
+};
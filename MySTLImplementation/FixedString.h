@@ -10,6 +10,7 @@
 #include <cassert>
 
 #include "Array.h"
+#include "Hash.h"
 
 /*
 * Wrapper around stack allocated char array
@@ -158,18 +159,7 @@ public:
 
     uint64_t GetHashCode() const
     {
-        /* simple djb2 hashing */
-        const char* it = m_String;
-        uint64_t hashv = 5381;
-        uint64_t c = *it++;
-
-        while (c)
-        {
-            hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-            c = *it++;
-        }
-
-        return hashv;
+        return Hashing::HashBytes(m_String, m_Length);
     }
 
 private:
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include "Hash.h"
+#include "Map.h"
+#include "Span.h"
+
+/*
+* Immutable map with minimal perfect hash (CHD - compress, hash, displace). Keys are split into buckets by hash,
+* every bucket gets seed, which maps all its keys into distinct free slots of flat entry array of exactly
+* GetNumElements() entries. Buckets with single key store the slot directly.
+* Find computes one hash, reads bucket seed and compares one key, there is no probing.
+* Keys with identical 64-bit hashes can't be told apart by any seed, build fails then and map stays empty (see IsValid)
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TFrozenMap
+{
+public:
+    using KeyValueType = TKeyValue<KeyType, ValueType>;
+    using ConstIterator = TMapIterator<const KeyValueType>;
+
+    TFrozenMap() = default;
+
+    template <typename OtherAllocatorType>
+    explicit TFrozenMap(const TMap<KeyType, ValueType, HashFunction, EqualCompare, OtherAllocatorType>& map)
+    {
+        Build(map);
+    }
+
+    /* Later pairs overwrite values of earlier ones with the same key */
+    explicit TFrozenMap(TSpan<const KeyValueType> keyValues)
+    {
+        TMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType> map;
+        map.InsertBatch(keyValues);
+        Build(map);
+    }
+
+    const KeyValueType* FindKeyValuePair(const KeyType& key) const
+    {
+        return FindEntry(key);
+    }
+
+    const ValueType* FindValue(const KeyType& key) const
+    {
+        const KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return FindEntry(key) != nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const KeyValueType* FindKeyValuePair(const LookupKeyType& key) const
+    {
+        return FindEntry(key);
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const ValueType* FindValue(const LookupKeyType& key) const
+    {
+        const KeyValueType* entry = FindEntry(key);
+        return entry ? &entry->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return FindEntry(key) != nullptr;
+    }
+
+    const ValueType& operator[](const KeyType& key) const
+    {
+        auto valuePtr = FindValue(key);
+        CHECK_ITEM_EXISTS(valuePtr);
+        return *valuePtr;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_Entries.GetNumElements();
+    }
+
+    /* False, if build failed because some keys had identical hashes */
+    bool IsValid() const
+    {
+        return m_bValid;
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator{m_Entries.UncheckedBegin()};
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator{m_Entries.UncheckedEnd()};
+    }
+
+private:
+    /* Average number of keys per bucket, bigger buckets mean smaller seed table, but longer build */
+    constexpr static int32_t AverageBucketSize = 4;
+
+    /* Build restarts with twice as many buckets, if some bucket can't find seed within this many attempts */
+    constexpr static int32_t MaxSeed = 1 << 16;
+
+    /* Larger buckets (practically impossible with good hash) also restart the build with more buckets */
+    constexpr static int32_t MaxBucketKeysOnStack = 64;
+
+    /* Each restart doubles number of buckets, build gives up after this many restarts */
+    constexpr static int32_t MaxBuildAttempts = 8;
+
+    TArray<KeyValueType, AllocatorType> m_Entries;
+
+    /* Seed of bucket, or ~slot for buckets with single key */
+    TArray<int32_t, AllocatorType> m_Seeds;
+
+    HashFunction m_HashFunction;
+    EqualCompare m_EqualCompare;
+
+    bool m_bValid = true;
+
+private:
+    /* Maps 32-bit value into [0, range) without division */
+    static int32_t Reduce(uint32_t value, int32_t range)
+    {
+        return static_cast<int32_t>((static_cast<uint64_t>(value) * static_cast<uint32_t>(range)) >> 32);
+    }
+
+    static int32_t GetSeededSlot(uint64_t hash, int32_t seed, int32_t numSlots)
+    {
+        return Reduce(static_cast<uint32_t>(Hashing::HashInteger(hash + static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ull)), numSlots);
+    }
+
+    /* Hash is remixed, so hash functions, which fill only low bits, still spread keys over all buckets */
+    int32_t GetBucket(uint64_t hash) const
+    {
+        return Reduce(static_cast<uint32_t>(Hashing::HashInteger(hash) >> 32), m_Seeds.GetNumElements());
+    }
+
+    int32_t GetSlot(uint64_t hash) const
+    {
+        int32_t seed = m_Seeds[GetBucket(hash)];
+        return seed < 0 ? ~seed : GetSeededSlot(hash, seed, m_Entries.GetNumElements());
+    }
+
+    template <typename LookupKeyType>
+    const KeyValueType* FindEntry(const LookupKeyType& key) const
+    {
+        if (m_Entries.IsEmpty())
+        {
+            return nullptr;
+        }
+
+        const KeyValueType& entry = m_Entries[GetSlot(m_HashFunction(key))];
+        return m_EqualCompare(key, entry.Key) ? &entry : nullptr;
+    }
+
+    template <typename MapType>
+    void Build(const MapType& map)
+    {
+        int32_t numElements = map.GetNumElements();
+
+        if (numElements == 0)
+        {
+            return;
+        }
+
+        TArray<const KeyValueType*> sources;
+        TArray<uint64_t> hashes;
+        sources.AllocAbs(numElements);
+        hashes.AllocAbs(numElements);
+
+        for (const KeyValueType& keyValue : map)
+        {
+            sources.Add(&keyValue);
+            hashes.Add(m_HashFunction(keyValue.Key));
+        }
+
+        if (HasDuplicateHashes(hashes))
+        {
+            m_Seeds.Empty();
+            m_bValid = false;
+            return;
+        }
+
+        TArray<int32_t> slotSources;
+        int32_t numBuckets = (numElements + AverageBucketSize - 1) / AverageBucketSize;
+        int32_t attempt = 0;
+
+        while (!TryBuild(numBuckets, hashes, slotSources))
+        {
+            if (++attempt == MaxBuildAttempts)
+            {
+                m_Seeds.Empty();
+                m_bValid = false;
+                return;
+            }
+
+            numBuckets *= 2;
+        }
+
+        m_Entries.AllocAbs(numElements);
+
+        for (int32_t slot = 0; slot < numElements; ++slot)
+        {
+            m_Entries.Add(*sources[slotSources[slot]]);
+        }
+    }
+
+    bool TryBuild(int32_t numBuckets, const TArray<uint64_t>& hashes, TArray<int32_t>& slotSources)
+    {
+        int32_t numElements = hashes.GetNumElements();
+
+        m_Seeds.Empty();
+        m_Seeds.AddZeroed(numBuckets);
+
+        /* Group keys by bucket with counting sort */
+        TArray<int32_t> bucketStarts;
+        bucketStarts.AddZeroed(numBuckets + 1);
+
+        for (int32_t i = 0; i < numElements; ++i)
+        {
+            bucketStarts[GetBucket(hashes[i]) + 1]++;
+        }
+
+        for (int32_t bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            bucketStarts[bucket + 1] += bucketStarts[bucket];
+        }
+
+        TArray<int32_t> bucketKeys;
+        TArray<int32_t> cursors(bucketStarts);
+        bucketKeys.AddZeroed(numElements);
+
+        for (int32_t i = 0; i < numElements; ++i)
+        {
+            bucketKeys[cursors[GetBucket(hashes[i])]++] = i;
+        }
+
+        /* Largest buckets are placed first, while table is still mostly empty */
+        TArray<int32_t> buckets;
+        buckets.AllocAbs(numBuckets);
+
+        for (int32_t bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            buckets.Add(bucket);
+        }
+
+        auto getBucketSize = [&bucketStarts](int32_t bucket)
+        {
+            return bucketStarts[bucket + 1] - bucketStarts[bucket];
+        };
+
+        buckets.Sort([&getBucketSize](int32_t a, int32_t b)
+        {
+            return getBucketSize(a) > getBucketSize(b);
+        });
+
+        slotSources.Empty();
+        slotSources.AddZeroed(numElements);
+        slotSources.Fill(IndexNone);
+
+        int32_t slots[MaxBucketKeysOnStack];
+        int32_t bucketIndex = 0;
+
+        for (; bucketIndex < numBuckets && getBucketSize(buckets[bucketIndex]) > 1; ++bucketIndex)
+        {
+            int32_t bucket = buckets[bucketIndex];
+            int32_t size = getBucketSize(bucket);
+            const int32_t* keys = bucketKeys.GetData() + bucketStarts[bucket];
+
+            if (size > MaxBucketKeysOnStack)
+            {
+                return false;
+            }
+
+            int32_t seed = 0;
+
+            for (; seed < MaxSeed; ++seed)
+            {
+                if (TryPlaceBucket(keys, size, seed, hashes, slotSources, slots))
+                {
+                    break;
+                }
+            }
+
+            if (seed == MaxSeed)
+            {
+                return false;
+            }
+
+            for (int32_t i = 0; i < size; ++i)
+            {
+                slotSources[slots[i]] = keys[i];
+            }
+
+            m_Seeds[bucket] = seed;
+        }
+
+        /* Buckets with one key take free slots in order */
+        int32_t freeSlot = 0;
+
+        for (; bucketIndex < numBuckets && getBucketSize(buckets[bucketIndex]) == 1; ++bucketIndex)
+        {
+            int32_t bucket = buckets[bucketIndex];
+
+            while (slotSources[freeSlot] != IndexNone)
+            {
+                ++freeSlot;
+            }
+
+            slotSources[freeSlot] = bucketKeys[bucketStarts[bucket]];
+            m_Seeds[bucket] = ~freeSlot;
+        }
+
+        return true;
+    }
+
+    static bool HasDuplicateHashes(const TArray<uint64_t>& hashes)
+    {
+        TArray<uint64_t> sorted(hashes);
+        sorted.Sort([](uint64_t a, uint64_t b)
+        {
+            return a < b;
+        });
+
+        for (int32_t i = 1; i < sorted.GetNumElements(); ++i)
+        {
+            if (sorted[i - 1] == sorted[i])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Computes slots of all keys of bucket for the seed, succeeds if they are free and distinct */
+    static bool TryPlaceBucket(const int32_t* keys, int32_t size, int32_t seed, const TArray<uint64_t>& hashes,
+        const TArray<int32_t>& slotSources, int32_t* slots)
+    {
+        int32_t numSlots = slotSources.GetNumElements();
+
+        for (int32_t i = 0; i < size; ++i)
+        {
+            slots[i] = GetSeededSlot(hashes[keys[i]], seed, numSlots);
+
+            if (slotSources[slots[i]] != IndexNone)
+            {
+                return false;
+            }
+
+            for (int32_t j = 0; j < i; ++j)
+            {
+                if (slots[j] == slots[i])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/*
+* Hash primitives used by DefaultHashFunctions.
+* Integers go through 64-bit finalizer, where every input bit affects every output bit, so both low bits
+* (used by power of two tables) and high bits are well distributed. Byte ranges use wyhash: 64x64->128 bit
+* multiply folded to 64 bits, reading 8 bytes per lane and up to 48 bytes per loop step in three independent lanes
+*/
+class Hashing
+{
+public:
+    /* splitmix64 finalizer, bijective, so different integers never collide */
+    constexpr static uint64_t HashInteger(uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    static uint64_t HashPointer(const void* pointer)
+    {
+        return HashInteger(reinterpret_cast<uintptr_t>(pointer));
+    }
+
+    /* Combines hash of next member of composite key into seed. Order matters: Combine(a, b) != Combine(b, a) */
+    constexpr static uint64_t HashCombine(uint64_t seed, uint64_t hash)
+    {
+        return Mix(seed ^ Secret[0], hash ^ Secret[1]);
+    }
+
+    static uint64_t HashBytes(const void* data, size_t length, uint64_t seed = 0)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        uint64_t a;
+        uint64_t b;
+
+        seed ^= Mix(seed ^ Secret[0], Secret[1]);
+
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                /* Two overlapping pairs of 4 byte reads cover any length from 4 to 16 without branches */
+                size_t offset = (length >> 3) << 2;
+                a = (Read4(p) << 32) | Read4(p + offset);
+                b = (Read4(p + length - 4) << 32) | Read4(p + length - 4 - offset);
+            }
+            else if (length > 0)
+            {
+                a = Read3(p, length);
+                b = 0;
+            }
+            else
+            {
+                a = 0;
+                b = 0;
+            }
+        }
+        else
+        {
+            size_t remaining = length;
+
+            if (remaining > 48)
+            {
+                uint64_t seed1 = seed;
+                uint64_t seed2 = seed;
+
+                do
+                {
+                    seed = Mix(Read8(p) ^ Secret[1], Read8(p + 8) ^ seed);
+                    seed1 = Mix(Read8(p + 16) ^ Secret[2], Read8(p + 24) ^ seed1);
+                    seed2 = Mix(Read8(p + 32) ^ Secret[3], Read8(p + 40) ^ seed2);
+                    p += 48;
+                    remaining -= 48;
+                }
+                while (remaining > 48);
+
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (remaining > 16)
+            {
+                seed = Mix(Read8(p) ^ Secret[1], Read8(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+
+            /* Last 16 bytes, may overlap already processed ones */
+            a = Read8(p + remaining - 16);
+            b = Read8(p + remaining - 8);
+        }
+
+        a ^= Secret[1];
+        b ^= seed;
+        Multiply(a, b);
+
+        return Mix(a ^ Secret[0] ^ length, b ^ Secret[1]);
+    }
+
+private:
+    constexpr static uint64_t Secret[4] = {0xA0761D6478BD642Full, 0xE7037ED1A0B428DBull, 0x8EBC6AF09C88C6E3ull, 0x589965CC75374CC3ull};
+
+    /* Full 128-bit product of a and b, low half in a, high half in b */
+    constexpr static void Multiply(uint64_t& a, uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+        if (!std::is_constant_evaluated())
+        {
+            a = _umul128(a, b, &b);
+            return;
+        }
+#endif
+        uint64_t ha = a >> 32;
+        uint64_t hb = b >> 32;
+        uint64_t la = static_cast<uint32_t>(a);
+        uint64_t lb = static_cast<uint32_t>(b);
+
+        uint64_t rh = ha * hb;
+        uint64_t rm0 = ha * lb;
+        uint64_t rm1 = hb * la;
+        uint64_t rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t carry = t < rl;
+
+        uint64_t lo = t + (rm1 << 32);
+        carry += lo < t;
+
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+    }
+
+    constexpr static uint64_t Mix(uint64_t a, uint64_t b)
+    {
+        Multiply(a, b);
+        return a ^ b;
+    }
+
+    static uint64_t Read8(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t Read4(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    /* Reads 1 to 3 bytes: first, middle and last (some of them may be the same byte) */
+    static uint64_t Read3(const uint8_t* p, size_t length)
+    {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+    }
+};
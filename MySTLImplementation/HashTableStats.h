@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+/*
+* Define HASH_TABLE_STATS to 1 to count rehashes and time spent in them. Costs two clock reads per rehash,
+* so it can stay enabled in staging builds. Other statistics are computed on request and always available
+*/
+#ifndef HASH_TABLE_STATS
+#define HASH_TABLE_STATS 0
+#endif
+
+/* Snapshot of hash table shape, returned by GetStats() of hash containers */
+struct FHashTableStats
+{
+    constexpr static int32_t NumHistogramBuckets = 16;
+
+    int32_t NumElements = 0;
+    int32_t NumSlots = 0;
+    double LoadFactor = 0.0;
+
+    /*
+    * Number of elements by distance from their home slot (in groups for TSwissMap), last bucket counts all longer ones.
+    * Many long probes at low load factor point to poor hash function, at high load factor to table being too full
+    */
+    int32_t ProbeLengthHistogram[NumHistogramBuckets]{};
+    int32_t MaxProbeLength = 0;
+    int64_t TotalProbeLength = 0;
+
+    /* Zero unless HASH_TABLE_STATS is enabled */
+    int64_t NumRehashes = 0;
+    double RehashSeconds = 0.0;
+
+    double GetAverageProbeLength() const
+    {
+        return NumElements > 0 ? static_cast<double>(TotalProbeLength) / NumElements : 0.0;
+    }
+
+    void AddProbeLength(int32_t probeLength)
+    {
+        ++ProbeLengthHistogram[probeLength < NumHistogramBuckets ? probeLength : NumHistogramBuckets - 1];
+        MaxProbeLength = probeLength > MaxProbeLength ? probeLength : MaxProbeLength;
+        TotalProbeLength += probeLength;
+    }
+};
+
+/* Rehash count and duration kept by hash table, empty when HASH_TABLE_STATS is disabled */
+class FHashRehashCounter
+{
+public:
+    /* Measures rehash from construction to destruction */
+    class FScope
+    {
+    public:
+        FScope(const FScope&) = delete;
+        FScope& operator=(const FScope&) = delete;
+
+#if HASH_TABLE_STATS
+        explicit FScope(FHashRehashCounter& counter) :
+            m_Counter(counter),
+            m_Start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~FScope()
+        {
+            ++m_Counter.m_NumRehashes;
+            m_Counter.m_RehashTime += std::chrono::steady_clock::now() - m_Start;
+        }
+
+    private:
+        FHashRehashCounter& m_Counter;
+        std::chrono::steady_clock::time_point m_Start;
+#else
+        explicit FScope(FHashRehashCounter&)
+        {
+        }
+#endif
+    };
+
+    void FillStats([[maybe_unused]] FHashTableStats& stats) const
+    {
+#if HASH_TABLE_STATS
+        stats.NumRehashes = m_NumRehashes;
+        stats.RehashSeconds = std::chrono::duration<double>(m_RehashTime).count();
+#endif
+    }
+
+#if HASH_TABLE_STATS
+private:
+    int64_t m_NumRehashes = 0;
+    std::chrono::steady_clock::duration m_RehashTime{};
+#endif
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "String.h"
+
+/*
+* String, which computes its hash once on construction or modification.
+* Hash is the same as String::GetHashCode of the same characters, so HashedString can be used both as key
+* and as lookup key for maps with String keys without rehashing. Comparisons reject different strings by hash first
+*/
+class HashedString
+{
+public:
+    HashedString() :
+        m_Hash{String::CharTraits::GetHash(nullptr, 0)}
+    {
+    }
+
+    HashedString(const char* str, int32_t length = -1) :
+        m_String{str, length}
+    {
+        UpdateHash();
+    }
+
+    explicit HashedString(std::string_view str) :
+        m_String{str}
+    {
+        UpdateHash();
+    }
+
+    explicit HashedString(const String& str) :
+        m_String{str}
+    {
+        UpdateHash();
+    }
+
+    explicit HashedString(String&& str) :
+        m_String{std::move(str)}
+    {
+        UpdateHash();
+    }
+
+    HashedString& operator=(const char* str)
+    {
+        m_String = str;
+        UpdateHash();
+        return *this;
+    }
+
+    void Append(const char* str, int32_t length)
+    {
+        m_String.Append(str, length);
+        UpdateHash();
+    }
+
+    void Clear()
+    {
+        m_String.Clear();
+        UpdateHash();
+    }
+
+    uint64_t GetHashCode() const
+    {
+        return m_Hash;
+    }
+
+    const String& GetString() const
+    {
+        return m_String;
+    }
+
+    const char* GetData() const
+    {
+        return m_String.GetData();
+    }
+
+    int32_t GetLength() const
+    {
+        return m_String.GetLength();
+    }
+
+    bool IsEmpty() const
+    {
+        return m_String.IsEmpty();
+    }
+
+    operator std::string_view() const
+    {
+        return m_String;
+    }
+
+    bool operator==(const HashedString& other) const
+    {
+        return m_Hash == other.m_Hash && std::string_view(m_String) == std::string_view(other.m_String);
+    }
+
+    bool operator!=(const HashedString& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const HashedString& other) const
+    {
+        return std::string_view(m_String) < std::string_view(other.m_String);
+    }
+
+private:
+    String m_String;
+    uint64_t m_Hash;
+
+private:
+    void UpdateHash()
+    {
+        m_Hash = m_String.GetHashCode();
+    }
+};
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include "Delegate.h"
+#include "Map.h"
+
+struct FLruCacheStats
+{
+    int64_t NumHits = 0;
+    int64_t NumMisses = 0;
+    int64_t NumEvictions = 0;
+};
+
+/*
+* Bounded cache, which evicts least recently used entries. Capacity is limited by number of entries and optionally
+* by sum of entry sizes in bytes passed to Add. Keys are indexed by TMap pointing into node pool, nodes are linked
+* into recency list by indices, so Find, Add and eviction are O(1) and don't allocate once pool is warmed up
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TLruCache
+{
+public:
+    /* Called with key and value of entry, which is evicted to make room (not on Remove or Clear) */
+    using EvictionDelegate = TDelegate<void(const KeyType&, ValueType&)>;
+
+    /* maxBytes == 0 means entries aren't limited by size */
+    explicit TLruCache(int32_t maxEntries, int64_t maxBytes = 0) :
+        m_MaxEntries(maxEntries),
+        m_MaxBytes(maxBytes)
+    {
+        assert(maxEntries > 0);
+    }
+
+    TLruCache(const TLruCache&) = delete;
+    TLruCache& operator=(const TLruCache&) = delete;
+
+    /* Returns value and marks entry as most recently used, counts hit or miss */
+    ValueType* Find(const KeyType& key)
+    {
+        return Touch(m_Index.FindValue(key));
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    ValueType* Find(const LookupKeyType& key)
+    {
+        return Touch(m_Index.FindValue(key));
+    }
+
+    /* Returns value without changing recency and statistics */
+    const ValueType* Peek(const KeyType& key) const
+    {
+        const int32_t* node = m_Index.FindValue(key);
+        return node ? &m_Nodes[*node].Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const ValueType* Peek(const LookupKeyType& key) const
+    {
+        const int32_t* node = m_Index.FindValue(key);
+        return node ? &m_Nodes[*node].Value : nullptr;
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return m_Index.Contains(key);
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return m_Index.Contains(key);
+    }
+
+    /* Adds or replaces entry, makes it most recently used and evicts old entries until cache fits into capacity */
+    ValueType& Add(const KeyType& key, const ValueType& value, int64_t numBytes = 0)
+    {
+        return AddImpl(key, value, numBytes);
+    }
+
+    ValueType& Add(const KeyType& key, ValueType&& value, int64_t numBytes = 0)
+    {
+        return AddImpl(key, std::move(value), numBytes);
+    }
+
+    /* Returns cached value or adds one returned by factory() (counted as miss), for caching expensive computations */
+    template <typename FactoryType>
+    ValueType& FindOrAdd(const KeyType& key, FactoryType&& factory, int64_t numBytes = 0)
+    {
+        if (ValueType* value = Find(key))
+        {
+            return *value;
+        }
+
+        return AddImpl(key, factory(), numBytes);
+    }
+
+    bool Remove(const KeyType& key)
+    {
+        const int32_t* node = m_Index.FindValue(key);
+
+        if (!node)
+        {
+            return false;
+        }
+
+        int32_t nodeIndex = *node;
+        m_Index.Remove(key);
+        FreeNode(nodeIndex);
+
+        return true;
+    }
+
+    /* Removes all entries without calling eviction delegate. Node pool memory is kept */
+    void Clear()
+    {
+        for (int32_t node = m_Head; node != IndexNone;)
+        {
+            int32_t next = m_Nodes[node].Next;
+            FreeNode(node);
+            node = next;
+        }
+
+        m_Index.Clear();
+    }
+
+    /* Shrinking capacity evicts entries immediately */
+    void SetCapacity(int32_t maxEntries, int64_t maxBytes = 0)
+    {
+        assert(maxEntries > 0);
+
+        m_MaxEntries = maxEntries;
+        m_MaxBytes = maxBytes;
+        EvictToCapacity(IndexNone);
+    }
+
+    EvictionDelegate& OnEviction()
+    {
+        return m_OnEviction;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_Index.GetNumElements();
+    }
+
+    int64_t GetNumBytes() const
+    {
+        return m_NumBytes;
+    }
+
+    int32_t GetMaxEntries() const
+    {
+        return m_MaxEntries;
+    }
+
+    int64_t GetMaxBytes() const
+    {
+        return m_MaxBytes;
+    }
+
+    const FLruCacheStats& GetStats() const
+    {
+        return m_Stats;
+    }
+
+    void ResetStats()
+    {
+        m_Stats = FLruCacheStats{};
+    }
+
+    /* Calls func(const KeyType&, const ValueType&) from most to least recently used entry */
+    template <typename FuncType>
+    void ForEach(FuncType&& func) const
+    {
+        for (int32_t node = m_Head; node != IndexNone; node = m_Nodes[node].Next)
+        {
+            func(m_Nodes[node].Key, m_Nodes[node].Value);
+        }
+    }
+
+private:
+    struct FNode
+    {
+        KeyType Key{};
+        ValueType Value{};
+        int64_t NumBytes = 0;
+
+        /* Neighbours in recency list, Next also links free nodes */
+        int32_t Prev = IndexNone;
+        int32_t Next = IndexNone;
+    };
+
+    TMap<KeyType, int32_t, HashFunction, EqualCompare, AllocatorType> m_Index;
+    TArray<FNode, AllocatorType> m_Nodes;
+
+    /* Most and least recently used nodes */
+    int32_t m_Head = IndexNone;
+    int32_t m_Tail = IndexNone;
+
+    int32_t m_FreeList = IndexNone;
+
+    int32_t m_MaxEntries;
+    int64_t m_MaxBytes;
+    int64_t m_NumBytes = 0;
+
+    FLruCacheStats m_Stats;
+    EvictionDelegate m_OnEviction;
+
+private:
+    ValueType* Touch(const int32_t* node)
+    {
+        if (!node)
+        {
+            ++m_Stats.NumMisses;
+            return nullptr;
+        }
+
+        ++m_Stats.NumHits;
+        MoveToFront(*node);
+
+        return &m_Nodes[*node].Value;
+    }
+
+    template <typename ValueArgType>
+    ValueType& AddImpl(const KeyType& key, ValueArgType&& value, int64_t numBytes)
+    {
+        int32_t nodeIndex;
+
+        if (const int32_t* node = m_Index.FindValue(key))
+        {
+            nodeIndex = *node;
+            m_NumBytes -= m_Nodes[nodeIndex].NumBytes;
+            MoveToFront(nodeIndex);
+        }
+        else
+        {
+            nodeIndex = AllocateNode();
+            m_Nodes[nodeIndex].Key = key;
+            LinkFront(nodeIndex);
+            m_Index.Insert(key, nodeIndex);
+        }
+
+        FNode& node = m_Nodes[nodeIndex];
+        node.Value = std::forward<ValueArgType>(value);
+        node.NumBytes = numBytes;
+        m_NumBytes += numBytes;
+
+        EvictToCapacity(nodeIndex);
+
+        return m_Nodes[nodeIndex].Value;
+    }
+
+    /* Evicts from the tail, but never the entry which is being added, even if it alone exceeds byte limit */
+    void EvictToCapacity(int32_t keepNode)
+    {
+        while (m_Tail != IndexNone && m_Tail != keepNode &&
+            (m_Index.GetNumElements() > m_MaxEntries || (m_MaxBytes > 0 && m_NumBytes > m_MaxBytes)))
+        {
+            int32_t node = m_Tail;
+
+            m_OnEviction.ExecuteIfBound(m_Nodes[node].Key, m_Nodes[node].Value);
+            ++m_Stats.NumEvictions;
+
+            m_Index.Remove(m_Nodes[node].Key);
+            FreeNode(node);
+        }
+    }
+
+    int32_t AllocateNode()
+    {
+        if (m_FreeList == IndexNone)
+        {
+            m_Nodes.Add(FNode{});
+            return m_Nodes.GetNumElements() - 1;
+        }
+
+        int32_t node = m_FreeList;
+        m_FreeList = m_Nodes[node].Next;
+
+        return node;
+    }
+
+    /* Unlinks node, releases key and value and puts node to free list */
+    void FreeNode(int32_t nodeIndex)
+    {
+        Unlink(nodeIndex);
+
+        FNode& node = m_Nodes[nodeIndex];
+        m_NumBytes -= node.NumBytes;
+
+        node.Key = KeyType{};
+        node.Value = ValueType{};
+        node.NumBytes = 0;
+        node.Prev = IndexNone;
+        node.Next = m_FreeList;
+
+        m_FreeList = nodeIndex;
+    }
+
+    void LinkFront(int32_t nodeIndex)
+    {
+        FNode& node = m_Nodes[nodeIndex];
+        node.Prev = IndexNone;
+        node.Next = m_Head;
+
+        if (m_Head != IndexNone)
+        {
+            m_Nodes[m_Head].Prev = nodeIndex;
+        }
+        else
+        {
+            m_Tail = nodeIndex;
+        }
+
+        m_Head = nodeIndex;
+    }
+
+    void Unlink(int32_t nodeIndex)
+    {
+        FNode& node = m_Nodes[nodeIndex];
+
+        if (node.Prev != IndexNone)
+        {
+            m_Nodes[node.Prev].Next = node.Next;
+        }
+        else
+        {
+            m_Head = node.Next;
+        }
+
+        if (node.Next != IndexNone)
+        {
+            m_Nodes[node.Next].Prev = node.Prev;
+        }
+        else
+        {
+            m_Tail = node.Prev;
+        }
+    }
+
+    void MoveToFront(int32_t nodeIndex)
+    {
+        if (nodeIndex != m_Head)
+        {
+            Unlink(nodeIndex);
+            LinkFront(nodeIndex);
+        }
+    }
+};
@@ -2,12 +2,17 @@
 
 #include <cstdint>
 #include <algorithm>
+#include <bit>
 #include <memory>
 
 #include "Array.h"
 #include "FixedString.h"
+#include "Hash.h"
+#include "HashedString.h"
+#include "HashTableStats.h"
 #include "Optional.h"
 #include "String.h"
+#include "Platform.h"
 #include <string>
 
 #define CHECK_ITEM_EXISTS(Ptr) assert((Ptr) != nullptr && "Item with this key doesn't exits")
@@ -18,12 +23,12 @@ struct TKeyValue
     KeyType Key;
     ValueType Value;
 
-    TKeyValue() = default;
+    constexpr TKeyValue() = default;
 
     using SelfClass = TKeyValue<KeyType, ValueType>;
 
     template <typename ...Args>
-    TKeyValue(const KeyType& key, Args&& ...args) :
+    constexpr TKeyValue(const KeyType& key, Args&& ...args) :
         Key{key},
         Value{std::forward<Args>(args)...}
     {
@@ -36,10 +41,133 @@ struct TKeyValue
     TKeyValue& operator=(SelfClass&& temp) = default;
 };
 
-// Container that maps Key to Value.
-// It's search, inserting have logarithmic complexity
+/*
+* Hashes all string like types the same way, so maps with string keys can be searched without constructing temporary key.
+* Integers are hashed by value (int32_t and int64_t with the same value have the same hash), floats as doubles
+*/
+struct DefaultHashFunctions
+{
+    using is_transparent = void;
+
+    uint64_t operator()(double element) const
+    {
+        /* -0.0 == 0.0, so they must have the same hash */
+        uint64_t bits;
+        element = element == 0.0 ? 0.0 : element;
+        memcpy(&bits, &element, sizeof(bits));
+        return Hashing::HashInteger(bits);
+    }
+
+    uint64_t operator()(float element) const
+    {
+        return (*this)(static_cast<double>(element));
+    }
+
+    template <std::integral IntegerType>
+    uint64_t operator()(IntegerType element) const
+    {
+        if constexpr (std::is_signed_v<IntegerType>)
+        {
+            return Hashing::HashInteger(static_cast<uint64_t>(static_cast<int64_t>(element)));
+        }
+        else
+        {
+            return Hashing::HashInteger(static_cast<uint64_t>(element));
+        }
+    }
+
+    template <typename EnumType> requires std::is_enum_v<EnumType>
+    uint64_t operator()(EnumType element) const
+    {
+        return (*this)(static_cast<std::underlying_type_t<EnumType>>(element));
+    }
+
+    template <typename PointeeType> requires (!TStringLike<PointeeType*>)
+    uint64_t operator()(PointeeType* element) const
+    {
+        return Hashing::HashPointer(element);
+    }
+
+    uint64_t operator()(const String& element) const
+    {
+        return element.GetHashCode();
+    }
+
+    /* Precomputed */
+    uint64_t operator()(const HashedString& element) const
+    {
+        return element.GetHashCode();
+    }
+
+    template <int32_t N>
+    uint64_t operator()(const CString<N>& element) const
+    {
+        return element.GetHashCode();
+    }
+
+    template <TStringLike StringType>
+    uint64_t operator()(const StringType& element) const
+    {
+        std::string_view view = element;
+        return Hashing::HashBytes(view.data(), view.size());
+    }
+};
+
+/* Equality, which compares any two string like types by characters */
+struct DefaultEqualCompare
+{
+    using is_transparent = void;
+
+    template <typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (std::is_same_v<A, HashedString> && std::is_same_v<B, HashedString>)
+        {
+            return a == b;
+        }
+        else if constexpr (TStringLike<A> && TStringLike<B>)
+        {
+            return std::string_view(a) == std::string_view(b);
+        }
+        else
+        {
+            return a == b;
+        }
+    }
+};
+
+/* Ordering, which compares any two string like types by characters */
+struct DefaultLessCompare
+{
+    using is_transparent = void;
+
+    template <typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (TStringLike<A> && TStringLike<B>)
+        {
+            return std::string_view(a) < std::string_view(b);
+        }
+        else
+        {
+            return a < b;
+        }
+    }
+};
+
+/*
+* Map can be searched by LookupKeyType without converting it to KeyType, when its functors declare is_transparent.
+* Arithmetic lookup keys are always converted, so they are hashed exactly like stored keys
+*/
+template <typename LookupKeyType, typename KeyType, typename... Functors>
+concept THeterogeneousLookup = !std::is_same_v<LookupKeyType, KeyType> && !std::is_arithmetic_v<LookupKeyType> &&
+    (requires { typename Functors::is_transparent; } && ...);
+
+// Container that maps Key to Value, sorted by Key.
+// It's search has logarithmic complexity, inserting is binary search plus shift of following elements
 // Removing cost is same as moving array elements to new location
-template <typename KeyType, typename ValueType, typename Predicate = std::less<KeyType>>
+// Use BulkLoad or InsertDeferred to build large maps with single sort
+template <typename KeyType, typename ValueType, typename Predicate = DefaultLessCompare>
 class TOrderedMap
 {
 public:
@@ -53,8 +181,10 @@ public:
     {
         for (auto& [key, value] : map)
         {
-            Insert(key, value);
+            m_Pending.EmplaceBack(key, value);
         }
+
+        FlushPending();
     }
 
     void Insert(const KeyType& key, const ValueType& value)
@@ -62,16 +192,39 @@ public:
         Emplace(key, value);
     }
 
+    /* Binary searches position of key and shifts following entries by one. Existing value of the key is replaced */
     template <typename ...Args>
     void Emplace(const KeyType& key, Args&& ...args)
     {
-        m_Values.EmplaceBack(key, std::move(ValueType(std::forward<Args>(args)...)));
+        FlushPending();
+
+        int32_t index = SortedLowerBoundIndex(key);
 
-        m_Values.Sort([](const ArrayType& a, const ArrayType& b)
+        if (index < m_Values.GetNumElements() && !Predicate{}(key, m_Values[index].Key))
         {
-            Predicate pd{};
-            return pd(a.Key, b.Key);
-        });
+            m_Values[index].Value = ValueType(std::forward<Args>(args)...);
+            return;
+        }
+
+        m_Values.EmplaceAt(index, key, std::forward<Args>(args)...);
+        UpdateEytzinger();
+    }
+
+    /*
+    * Buffers entry without touching sorted entries. All buffered entries are sorted and merged in one pass
+    * on next access, so building map with n inserts costs O(n log n) instead of O(n^2).
+    * Const accessors merge buffer too, don't share map between threads while it has deferred inserts
+    */
+    void InsertDeferred(const KeyType& key, const ValueType& value)
+    {
+        m_Pending.EmplaceBack(key, value);
+    }
+
+    /* Inserts all pairs with single sort and merge. Later pairs overwrite values of earlier ones with the same key */
+    void BulkLoad(TSpan<const ArrayType> keyValues)
+    {
+        m_Pending.Append(keyValues.GetData(), keyValues.GetNumElements());
+        FlushPending();
     }
 
     const ValueType* Find(const KeyType& key) const
@@ -86,6 +239,20 @@ public:
         return v ? const_cast<ValueType*>(&v->Value) : nullptr;
     }
 
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    const ValueType* Find(const LookupKeyType& key) const
+    {
+        const ArrayType* v = FindValue(key);
+        return v ? &v->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    ValueType* Find(const LookupKeyType& key)
+    {
+        const ArrayType* v = FindValue(key);
+        return v ? const_cast<ValueType*>(&v->Value) : nullptr;
+    }
+
     const ValueType& operator[](const KeyType& key) const
     {
         auto it = Find(key);
@@ -102,21 +269,26 @@ public:
 
     int32_t GetNumElements() const
     {
+        FlushPending();
         return m_Values.GetNumElements();
     }
 
-    auto begin() const
+    const_iterator begin() const
     {
-        return m_Values.begin();
+        FlushPending();
+        return std::as_const(m_Values).begin();
     }
 
-    auto end() const
+    const_iterator end() const
     {
-        return m_Values.end();
+        FlushPending();
+        return std::as_const(m_Values).end();
     }
 
     TArray<KeyType> GetKeys() const
     {
+        FlushPending();
+
         TArray<KeyType> keys;
         keys.AllocAbs(m_Values.GetNumElements());
 
@@ -134,102 +306,293 @@ public:
         return it != nullptr;
     }
 
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, Predicate>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return FindValue(key) != nullptr;
+    }
+
+    /* First entry with key not less than given key, or end() */
+    const_iterator LowerBound(const KeyType& key) const
+    {
+        FlushPending();
+        return const_iterator{std::as_const(m_Values), LowerBoundIndex(key)};
+    }
+
+    /* First entry with key greater than given key, or end() */
+    const_iterator UpperBound(const KeyType& key) const
+    {
+        FlushPending();
+        return const_iterator{std::as_const(m_Values), UpperBoundIndex(key)};
+    }
+
+    /* Entries with first <= key < last */
+    TSpan<const ArrayType> GetRange(const KeyType& first, const KeyType& last) const
+    {
+        FlushPending();
+
+        int32_t begin = LowerBoundIndex(first);
+        int32_t end = std::max(begin, LowerBoundIndex(last));
+
+        return TSpan<const ArrayType>{m_Values.GetData() + begin, end - begin};
+    }
+
+    /* Entry with the greatest key not greater than given key, or nullptr */
+    const ArrayType* Floor(const KeyType& key) const
+    {
+        FlushPending();
+
+        int32_t index = UpperBoundIndex(key);
+        return index > 0 ? &m_Values[index - 1] : nullptr;
+    }
+
+    /* Entry with the smallest key not less than given key, or nullptr */
+    const ArrayType* Ceiling(const KeyType& key) const
+    {
+        FlushPending();
+
+        int32_t index = LowerBoundIndex(key);
+        return index < m_Values.GetNumElements() ? &m_Values[index] : nullptr;
+    }
+
+    /*
+    * Searches copy of keys laid out in BFS order of implicit binary tree (Eytzinger layout). First levels of the tree
+    * share few cache lines and next levels are prefetched ahead, so large maps miss cache much less than with binary search.
+    * Layout is rebuilt by every modification (O(n) each), use it for maps, which are rarely modified.
+    * Searches only read the layout, so any number of threads may search the map, while nobody modifies it
+    * and it has no deferred inserts
+    */
+    void SetEytzingerLayout(bool enabled)
+    {
+        m_bEytzingerLayout = enabled;
+        FlushPending();
+        UpdateEytzinger();
+    }
+
     void Clear()
     {
-        m_Values.Clear();
+        m_Values.Empty();
+        m_Pending.Empty();
+        UpdateEytzinger();
     }
 
     void Remove(const KeyType& key)
     {
-        const ArrayType* m = FindValue(key);
-        int32_t index = static_cast<int32_t>(m - m_Values.GetData());
-        m_Values.RemoveIndex(index);
+        FlushPending();
+
+        int32_t index = SortedLowerBoundIndex(key);
+
+        if (index < m_Values.GetNumElements() && !Predicate{}(key, m_Values[index].Key))
+        {
+            m_Values.RemoveIndex(index);
+            UpdateEytzinger();
+        }
     }
 
 private:
-    TArray<ArrayType> m_Values;
+    /* Sorted entries and not yet merged deferred inserts, both are updated lazily by const accessors */
+    mutable TArray<ArrayType> m_Values;
+    mutable TArray<ArrayType> m_Pending;
 
-    const ArrayType* FindValue(const KeyType& key) const
+    /* Key in BFS order together with index of its entry in m_Values, so found index is in already loaded cache line */
+    struct FEytzingerNode
     {
-        int32_t l = 0;
-        int32_t r = m_Values.GetNumElements() - 1;
-        Predicate pred{};
+        KeyType Key;
+        int32_t Index;
+    };
 
-        while (l <= r)
-        {
-            int32_t m = l + (r - l) / 2;
+    /* Kept in sync with m_Values by every modification, mutable only because merging deferred inserts is const */
+    mutable TArray<FEytzingerNode> m_EytzingerNodes;
+    bool m_bEytzingerLayout = false;
 
-            // Check if x is present at mid
-            if (m_Values[m].Key == key)
+    template <typename LookupKeyType>
+    int32_t LowerBoundIndex(const LookupKeyType& key) const
+    {
+        if (m_bEytzingerLayout)
+        {
+            return EytzingerSearch([&key](const KeyType& nodeKey)
             {
-                return &m_Values[m];
-            }
+                return Predicate{}(nodeKey, key);
+            });
+        }
 
-            // If x greater, ignore left half
-            if (pred(m_Values[m].Key, key))
-            {
-                l = m + 1;
-            }
+        return SortedLowerBoundIndex(key);
+    }
 
-            // If x is smaller, ignore right half
-            else
-            {
-                r = m - 1;
-            }
-        }
+    /* Binary search directly over entries, used by modifications, so they don't rebuild Eytzinger layout */
+    template <typename LookupKeyType>
+    int32_t SortedLowerBoundIndex(const LookupKeyType& key) const
+    {
+        const ArrayType* it = Arrays::LowerBound(m_Values.GetData(), m_Values.GetData() + m_Values.GetNumElements(), key,
+            [](const ArrayType& a, const LookupKeyType& b)
+        {
+            return Predicate{}(a.Key, b);
+        });
 
-        // If we reach here, then element was not present
-        return nullptr;
+        return static_cast<int32_t>(it - m_Values.GetData());
     }
-};
 
-struct DefaultHashFunctions
-{
-    uint64_t operator()(double element) const
+    template <typename LookupKeyType>
+    int32_t UpperBoundIndex(const LookupKeyType& key) const
     {
-        return *((uint64_t*)&element);
+        if (m_bEytzingerLayout)
+        {
+            return EytzingerSearch([&key](const KeyType& nodeKey)
+            {
+                return !Predicate{}(key, nodeKey);
+            });
+        }
+
+        const ArrayType* it = Arrays::UpperBound(m_Values.GetData(), m_Values.GetData() + m_Values.GetNumElements(), key,
+            [](const LookupKeyType& a, const ArrayType& b)
+        {
+            return Predicate{}(a, b.Key);
+        });
+
+        return static_cast<int32_t>(it - m_Values.GetData());
     }
 
-    uint64_t operator()(float element) const
+    /* Returns index in m_Values of first entry, for which goRight(key) is false (or number of entries) */
+    template <typename GoRightFunc>
+    int32_t EytzingerSearch(GoRightFunc&& goRight) const
     {
-        return *((uint32_t*)&element);
+        /* Descendants of node k several levels below are stored contiguously, starting at NodesPerCacheLine * k */
+        constexpr int32_t NodesPerCacheLine = static_cast<int32_t>(std::bit_floor(std::max<size_t>(1, 64 / sizeof(FEytzingerNode))));
+
+        /* Tree is 1-based: children of node k are 2k and 2k + 1 */
+        const FEytzingerNode* nodes = m_EytzingerNodes.GetData() - 1;
+        int32_t numNodes = m_EytzingerNodes.GetNumElements();
+        int32_t k = 1;
+
+        while (k <= numNodes)
+        {
+            PLATFORM_PREFETCH(nodes + std::min(NodesPerCacheLine * k, numNodes));
+            k = 2 * k + (goRight(nodes[k].Key) ? 1 : 0);
+        }
+
+        /* Undo right turns made after the last left turn, that left turn was taken at the answer */
+        k >>= std::countr_one(static_cast<uint32_t>(k)) + 1;
+
+        return k != 0 ? nodes[k].Index : m_Values.GetNumElements();
     }
 
-    uint64_t operator()(int32_t element) const
+    /* Rebuilds layout after entries have changed, or frees it if layout is disabled */
+    void UpdateEytzinger() const
     {
-        return element;
+        if (!m_bEytzingerLayout)
+        {
+            m_EytzingerNodes.Empty();
+            return;
+        }
+
+        TArray<int32_t> indices;
+        indices.AddZeroed(m_Values.GetNumElements());
+        BuildEytzingerNode(indices, 0, 1);
+
+        m_EytzingerNodes.Empty();
+        m_EytzingerNodes.AllocAbs(m_Values.GetNumElements());
+
+        for (int32_t index : indices)
+        {
+            m_EytzingerNodes.Add(FEytzingerNode{m_Values[index].Key, index});
+        }
     }
 
-    uint64_t operator()(const std::string& element) const
+    /* In-order walk of the tree visits nodes in sorted order */
+    int32_t BuildEytzingerNode(TArray<int32_t>& indices, int32_t sortedIndex, int32_t k) const
     {
-        uint64_t n = std::hash<std::string>()(element);
-        return static_cast<uint64_t>(n);
+        if (k <= m_Values.GetNumElements())
+        {
+            sortedIndex = BuildEytzingerNode(indices, sortedIndex, 2 * k);
+            indices[k - 1] = sortedIndex++;
+
+            sortedIndex = BuildEytzingerNode(indices, sortedIndex, 2 * k + 1);
+        }
+
+        return sortedIndex;
     }
 
-    uint64_t operator()(const String& element) const
+    template <typename LookupKeyType>
+    const ArrayType* FindValue(const LookupKeyType& key) const
     {
-        return element.GetHashCode();
+        FlushPending();
+
+        int32_t index = LowerBoundIndex(key);
+
+        if (index < m_Values.GetNumElements() && !Predicate{}(key, m_Values[index].Key))
+        {
+            return &m_Values[index];
+        }
+
+        return nullptr;
     }
 
-    template <int32_t N>
-    uint64_t operator()(const CString<N>& element) const
+    void FlushPending() const
     {
-        return element.GetHashCode();
+        if (m_Pending.IsEmpty())
+        {
+            return;
+        }
+
+        Predicate pred{};
+
+        /* Stable, so the last of equal keys is the latest insert */
+        m_Pending.StableSort([&pred](const ArrayType& a, const ArrayType& b)
+        {
+            return pred(a.Key, b.Key);
+        });
+
+        TArray<ArrayType> merged;
+        merged.AllocAbs(m_Values.GetNumElements() + m_Pending.GetNumElements());
+
+        int32_t i = 0;
+        int32_t j = 0;
+
+        while (j < m_Pending.GetNumElements())
+        {
+            /* Skip to the latest of equal pending keys */
+            if (j + 1 < m_Pending.GetNumElements() && !pred(m_Pending[j].Key, m_Pending[j + 1].Key))
+            {
+                ++j;
+                continue;
+            }
+
+            ArrayType& pending = m_Pending[j];
+
+            while (i < m_Values.GetNumElements() && pred(m_Values[i].Key, pending.Key))
+            {
+                merged.Add(std::move(m_Values[i++]));
+            }
+
+            /* Pending entry replaces existing entry with the same key */
+            if (i < m_Values.GetNumElements() && !pred(pending.Key, m_Values[i].Key))
+            {
+                ++i;
+            }
+
+            merged.Add(std::move(pending));
+            ++j;
+        }
+
+        while (i < m_Values.GetNumElements())
+        {
+            merged.Add(std::move(m_Values[i++]));
+        }
+
+        m_Values.swap(merged);
+        m_Pending.Empty();
+        UpdateEytzinger();
     }
 };
 
-
-template <typename MapType, typename KeyType, typename AllocatorType>
+template <typename KeyValueType>
 class TMapIterator
 {
 public:
-    using SelfClass = TMapIterator<MapType, KeyType, AllocatorType>;
-    using KeyValueType = MapType::KeyValueType;
+    using SelfClass = TMapIterator<KeyValueType>;
 
-    TMapIterator(MapType& map, const TArray<KeyType, AllocatorType>& keys, int32_t index) :
-        m_Map{&map},
-        m_Keys(&keys),
-        m_Index(index)
+    explicit TMapIterator(KeyValueType* entry) :
+        m_Entry{entry}
     {
     }
 
@@ -238,127 +601,276 @@ public:
 
     SelfClass operator++(int)
     {
-        return SelfClass{*m_Map, *m_Keys, m_Index + 1};
+        return SelfClass{m_Entry++};
     }
 
     SelfClass& operator++()
     {
-        ++m_Index;
+        ++m_Entry;
         return *this;
     }
 
-    KeyValueType& operator*()
-    {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return *m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
-    }
-
-    const KeyValueType& operator*() const
-    {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return *m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
-    }
-
-    KeyValueType* operator->()
+    KeyValueType& operator*() const
     {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
+        return *m_Entry;
     }
 
-    const KeyValueType* operator->() const
+    KeyValueType* operator->() const
     {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
+        return m_Entry;
     }
 
     bool operator==(const SelfClass& other) const
     {
-        return m_Index == other.m_Index;
+        return m_Entry == other.m_Entry;
     }
 
     bool operator!=(const SelfClass& other) const
     {
-        return m_Index != other.m_Index;
+        return m_Entry != other.m_Entry;
     }
 
 private:
-    MapType* m_Map;
-    const TArray<KeyType, AllocatorType>* m_Keys;
-    int32_t m_Index{0};
+    KeyValueType* m_Entry;
 };
 
-template <typename MapType, typename KeyType, typename AllocatorType>
-class TConstMapIterator
+struct FHashIndexSlot
+{
+    /* Low bits of hash, enough to compute home slot and to filter out most of mismatches without touching entry */
+    uint32_t Hash{0};
+    int32_t EntryIndex{IndexNone};
+};
+
+/*
+* Open addressing index, which maps hashes to indices of entries stored elsewhere (in dense array of container).
+* Collisions are resolved with robin hood linear probing: entry which is further from its home slot
+* takes over the slot from entry closer to home, which keeps probe sequences short and lets lookup stop early.
+* Removing uses backward shift instead of tombstones, so index never degrades after many removals.
+* Number of slots is always power of two, so home slot is computed with mask instead of modulo
+*/
+template <typename AllocatorType = DefaultAllocator>
+class THashIndex
 {
 public:
-    using SelfClass = TConstMapIterator<MapType, KeyType, AllocatorType>;
-    using KeyValueType = MapType::KeyValueType;
+    constexpr static int32_t MinNumSlots = 16;
 
-    TConstMapIterator(MapType& map, const TArray<KeyType, AllocatorType>& keys, int32_t index) :
-        m_Map{&map},
-        m_Keys(&keys),
-        m_Index(index)
+    THashIndex() = default;
+
+    int32_t GetNumSlots() const
     {
+        return m_Slots.GetNumElements();
     }
 
-    TConstMapIterator(const SelfClass&) = default;
-    TConstMapIterator& operator=(const SelfClass&) = default;
+    /* Returns slot index, which entry satisfies isMatch(entryIndex), or IndexNone */
+    template <typename MatchFunc>
+    int32_t FindSlot(uint64_t hash, MatchFunc&& isMatch) const
+    {
+        if (m_Slots.IsEmpty())
+        {
+            return IndexNone;
+        }
+
+        uint32_t shortHash = static_cast<uint32_t>(hash);
+        int32_t mask = GetSlotMask();
+        int32_t pos = static_cast<int32_t>(shortHash & mask);
 
-    SelfClass operator++(int)
+        for (int32_t distance = 0; ; ++distance, pos = (pos + 1) & mask)
+        {
+            const FHashIndexSlot& slot = m_Slots[pos];
+
+            /* Robin hood invariant: entry would have taken this slot, if it was in the index */
+            if (slot.EntryIndex == IndexNone || GetProbeDistance(slot, pos) < distance)
+            {
+                return IndexNone;
+            }
+
+            if (slot.Hash == shortHash && isMatch(slot.EntryIndex))
+            {
+                return pos;
+            }
+        }
+    }
+
+    /* Returns entry index, which satisfies isMatch(entryIndex), or IndexNone */
+    template <typename MatchFunc>
+    int32_t Find(uint64_t hash, MatchFunc&& isMatch) const
     {
-        return SelfClass{*m_Map, *m_Keys, m_Index + 1};
+        int32_t slot = FindSlot(hash, std::forward<MatchFunc>(isMatch));
+        return slot != IndexNone ? m_Slots[slot].EntryIndex : IndexNone;
     }
 
-    SelfClass& operator++()
+    /* Starts loading home slot of hash into cache, so following Find or Insert doesn't wait for memory */
+    void Prefetch(uint64_t hash) const
     {
-        ++m_Index;
-        return *this;
+        if (!m_Slots.IsEmpty())
+        {
+            PLATFORM_PREFETCH(m_Slots.GetData() + (static_cast<int32_t>(hash) & GetSlotMask()));
+        }
     }
 
-    const KeyValueType& operator*() const
+    int32_t GetEntryIndex(int32_t slot) const
     {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return *m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
+        return m_Slots[slot].EntryIndex;
     }
 
-    const KeyValueType* operator->() const
+    /* Entry must not be already in index. Call Rebuild first if index is too full */
+    void Insert(uint64_t hash, int32_t entryIndex)
     {
-        assert(m_Keys->IsValidIndex(m_Index));
-        return m_Map->FindKeyValuePair(m_Keys->operator[](m_Index));
+        FHashIndexSlot entry{static_cast<uint32_t>(hash), entryIndex};
+        int32_t mask = GetSlotMask();
+        int32_t pos = static_cast<int32_t>(entry.Hash & mask);
+
+        for (int32_t distance = 0; ; ++distance, pos = (pos + 1) & mask)
+        {
+            FHashIndexSlot& slot = m_Slots[pos];
+
+            if (slot.EntryIndex == IndexNone)
+            {
+                slot = entry;
+                return;
+            }
+
+            int32_t slotDistance = GetProbeDistance(slot, pos);
+
+            /* Take slot from entry which is closer to its home and continue inserting that one */
+            if (slotDistance < distance)
+            {
+                std::swap(entry, slot);
+                distance = slotDistance;
+            }
+        }
     }
 
-    bool operator==(const SelfClass& other) const
+    /* Shifts following slots of the cluster back by one, until empty slot or slot at its home position */
+    void RemoveSlot(int32_t pos)
+    {
+        int32_t mask = GetSlotMask();
+        int32_t next = (pos + 1) & mask;
+
+        while (m_Slots[next].EntryIndex != IndexNone && GetProbeDistance(m_Slots[next], next) > 0)
+        {
+            m_Slots[pos] = m_Slots[next];
+
+            pos = next;
+            next = (next + 1) & mask;
+        }
+
+        m_Slots[pos] = FHashIndexSlot{};
+    }
+
+    /* Updates slot of entry, which was moved in dense array from oldEntryIndex to newEntryIndex */
+    void Relink(uint64_t hash, int32_t oldEntryIndex, int32_t newEntryIndex)
     {
-        return m_Index == other.m_Index;
+        int32_t slot = FindSlot(hash, [oldEntryIndex](int32_t entryIndex)
+        {
+            return entryIndex == oldEntryIndex;
+        });
+
+        assert(slot != IndexNone);
+        m_Slots[slot].EntryIndex = newEntryIndex;
     }
 
-    bool operator!=(const SelfClass& other) const
+    bool IsFull(int32_t numEntries) const
     {
-        return m_Index != other.m_Index;
+        return numEntries > MaxLoadFactor * m_Slots.GetNumElements();
     }
 
+    /* Rebuilds index with given number of slots (rounded up to power of two) from stored hashes, keys are not hashed again */
+    void Rebuild(int32_t numSlots, const uint64_t* hashes, int32_t numEntries)
+    {
+        FHashRehashCounter::FScope rehashScope{m_RehashCounter};
+        int32_t newNumSlots = MinNumSlots;
+
+        while (newNumSlots < numSlots)
+        {
+            newNumSlots *= 2;
+        }
+
+        TArray<FHashIndexSlot, AllocatorType> slots;
+        slots.AddZeroed(newNumSlots);
+        m_Slots.swap(slots);
+
+        for (int32_t i = 0; i < numEntries; ++i)
+        {
+            Insert(hashes[i], i);
+        }
+    }
+
+    /* Grows index, so it can hold numEntries without exceeding load factor */
+    void Grow(int32_t numEntries, const uint64_t* hashes, int32_t numStoredEntries)
+    {
+        int32_t numSlots = m_Slots.IsEmpty() ? MinNumSlots : m_Slots.GetNumElements();
+
+        while (numEntries > MaxLoadFactor * numSlots)
+        {
+            numSlots *= 2;
+        }
+
+        Rebuild(numSlots, hashes, numStoredEntries);
+    }
+
+    void Clear()
+    {
+        m_Slots.Fill(FHashIndexSlot{});
+    }
+
+    /* Walks all slots, so it's O(number of slots) */
+    FHashTableStats GetStats() const
+    {
+        FHashTableStats stats;
+        stats.NumSlots = m_Slots.GetNumElements();
+
+        for (int32_t pos = 0; pos < stats.NumSlots; ++pos)
+        {
+            if (m_Slots[pos].EntryIndex != IndexNone)
+            {
+                ++stats.NumElements;
+                stats.AddProbeLength(GetProbeDistance(m_Slots[pos], pos));
+            }
+        }
+
+        stats.LoadFactor = stats.NumSlots > 0 ? static_cast<double>(stats.NumElements) / stats.NumSlots : 0.0;
+        m_RehashCounter.FillStats(stats);
+
+        return stats;
+    }
+
+private:
+    constexpr static double MaxLoadFactor = 0.75;
+
+    TArray<FHashIndexSlot, AllocatorType> m_Slots;
+
+    FHashRehashCounter m_RehashCounter;
+
 private:
-    MapType* m_Map;
-    const TArray<KeyType, AllocatorType>* m_Keys;
-    int32_t m_Index{0};
+    int32_t GetSlotMask() const
+    {
+        return m_Slots.GetNumElements() - 1;
+    }
+
+    /* How far is slot from home slot of the hash stored in it */
+    int32_t GetProbeDistance(const FHashIndexSlot& slot, int32_t pos) const
+    {
+        return static_cast<int32_t>((static_cast<uint32_t>(pos) - static_cast<uint32_t>(slot.Hash)) & static_cast<uint32_t>(GetSlotMask()));
+    }
 };
 
-template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = std::equal_to<KeyType>,
+/*
+* Hash map, which keeps entries densely packed in single array and hash index (THashIndex) pointing into it.
+* Iteration walks the dense array directly, Remove moves last entry into freed place, so it's O(1)
+* Order of iteration is insertion order, until first Remove
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
     typename AllocatorType = DefaultAllocator>
 class TMap
 {
-    double MaxLoadFactor()
-    {
-        return 0.75;
-    }
-
 public:
     using KeyValueType = TKeyValue<KeyType, ValueType>;
 
     using SelfClass = TMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType>;
 
-    using Iterator = TMapIterator<SelfClass, KeyType, AllocatorType>;
-    using ConstIterator = TConstMapIterator<const SelfClass, KeyType, AllocatorType>;
+    using Iterator = TMapIterator<KeyValueType>;
+    using ConstIterator = TMapIterator<const KeyValueType>;
 
     TMap() = default;
 
@@ -379,105 +891,166 @@ public:
 
     void Insert(const KeyType& key, const ValueType& value)
     {
-        int32_t index{IndexNone};
+        uint64_t hash = m_HashFunction(key);
+        int32_t index = FindEntryIndex(key, hash);
 
-        if (LookupIndex(key, index))
+        if (index != IndexNone)
         {
-            m_Buckets[index].Value = value;
+            m_Entries[index].Value = value;
         }
         else
         {
-            if (m_Keys.GetNumElements() + 1 > MaxLoadFactor() * m_Buckets.GetNumElements())
-            {
-                Rehash();
-            }
+            AddEntry(hash, key, value);
+        }
+    }
 
-            uint64_t hash = m_HashFunction(key);
-            int32_t pos = static_cast<int32_t>(hash % m_Buckets.GetNumAlloc());
+    /* Allocates entries and index for numElements, so inserting up to that many elements doesn't rehash */
+    void Reserve(int32_t numElements)
+    {
+        m_Entries.AllocAbs(numElements);
+        m_Hashes.AllocAbs(numElements);
 
-            m_Buckets.SetIndex(TKeyValue<KeyType, ValueType>{key, value}, pos);
-            m_Keys.Add(key);
+        if (m_Index.IsFull(numElements))
+        {
+            m_Index.Grow(numElements, m_Hashes.GetData(), m_Hashes.GetNumElements());
+        }
+    }
 
-            m_Hashes[pos] = hash;
+    /*
+    * Inserts all pairs (later pairs overwrite values of earlier ones with the same key).
+    * Table is sized once up front and hashes of whole batch are computed before inserting,
+    * so slots are already prefetched, when they are probed
+    */
+    void InsertBatch(TSpan<const KeyValueType> keyValues)
+    {
+        constexpr int32_t BatchSize = 16;
+        uint64_t hashes[BatchSize];
+
+        Reserve(m_Entries.GetNumElements() + keyValues.GetNumElements());
+
+        for (int32_t start = 0; start < keyValues.GetNumElements(); start += BatchSize)
+        {
+            int32_t count = std::min(BatchSize, keyValues.GetNumElements() - start);
+
+            for (int32_t i = 0; i < count; ++i)
+            {
+                hashes[i] = m_HashFunction(keyValues[start + i].Key);
+                m_Index.Prefetch(hashes[i]);
+            }
+
+            for (int32_t i = 0; i < count; ++i)
+            {
+                const KeyValueType& keyValue = keyValues[start + i];
+                int32_t index = FindEntryIndex(keyValue.Key, hashes[i]);
+
+                if (index != IndexNone)
+                {
+                    m_Entries[index].Value = keyValue.Value;
+                }
+                else
+                {
+                    AddEntry(hashes[i], keyValue.Key, keyValue.Value);
+                }
+            }
         }
     }
 
     void Remove(const KeyType& key)
     {
-        int32_t index;
+        uint64_t hash = m_HashFunction(key);
+        int32_t slot = m_Index.FindSlot(hash, [this, &key](int32_t entryIndex)
+        {
+            return m_EqualCompare(key, m_Entries[entryIndex].Key);
+        });
+
+        if (slot == IndexNone)
+        {
+            return;
+        }
+
+        int32_t index = m_Index.GetEntryIndex(slot);
+        int32_t lastIndex = m_Entries.GetNumElements() - 1;
+
+        m_Index.RemoveSlot(slot);
 
-        if (LookupIndex(key, index))
+        if (index != lastIndex)
         {
-            m_Hashes[index] = 0;
-            m_Keys.Remove(key);
+            m_Index.Relink(m_Hashes[lastIndex], lastIndex, index);
         }
+
+        m_Entries.RemoveIndexSwap(index);
+        m_Hashes.RemoveIndexSwap(index);
     }
 
     Iterator begin()
     {
-        return Iterator{*this, m_Keys, 0};
+        return Iterator{m_Entries.UncheckedBegin()};
     }
 
     Iterator end()
     {
-        return Iterator{*this, m_Keys, m_Keys.GetNumElements()};
+        return Iterator{m_Entries.UncheckedEnd()};
     }
 
     ConstIterator begin() const
     {
-        return ConstIterator{*this, m_Keys, 0};
+        return ConstIterator{m_Entries.UncheckedBegin()};
     }
 
     ConstIterator end() const
     {
-        return ConstIterator{*this, m_Keys, m_Keys.GetNumElements()};
+        return ConstIterator{m_Entries.UncheckedEnd()};
     }
 
     /* Returns key value pair or nullptr if couldn't be find. Key property must not be changed */
     TKeyValue<KeyType, ValueType>* FindKeyValuePair(const KeyType& key)
     {
-        if (m_Buckets.IsEmpty())
-        {
-            return nullptr;
-        }
-
-        uint64_t hash = m_HashFunction(key);
-        int32_t pos = static_cast<int32_t>(hash % m_Buckets.GetNumAlloc());
-
-        if (m_Hashes[pos] == hash && m_EqualCompare(key, m_Buckets[pos].Key))
-        {
-            return &m_Buckets[pos];
-        }
-
-        return nullptr;
+        int32_t index = FindEntryIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Entries[index] : nullptr;
     }
 
     /* Returns key value pair or nullptr if couldn't be find. Key property must not be changed */
     const TKeyValue<KeyType, ValueType>* FindKeyValuePair(const KeyType& key) const
     {
-        if (m_Buckets.IsEmpty())
-        {
-            return nullptr;
-        }
+        int32_t index = FindEntryIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Entries[index] : nullptr;
+    }
 
-        uint64_t hash = m_HashFunction(key);
-        int32_t pos = static_cast<int32_t>(hash % m_Buckets.GetNumAlloc());
+    ValueType* FindValue(const KeyType& key)
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
 
-        if (m_Hashes[pos] == hash && m_EqualCompare(key, m_Buckets[pos].Key))
-        {
-            return &m_Buckets[pos];
-        }
+    const ValueType* FindValue(const KeyType& key) const
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
 
-        return nullptr;
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    TKeyValue<KeyType, ValueType>* FindKeyValuePair(const LookupKeyType& key)
+    {
+        int32_t index = FindEntryIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Entries[index] : nullptr;
     }
 
-    ValueType* FindValue(const KeyType& key)
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const TKeyValue<KeyType, ValueType>* FindKeyValuePair(const LookupKeyType& key) const
+    {
+        int32_t index = FindEntryIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Entries[index] : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    ValueType* FindValue(const LookupKeyType& key)
     {
         auto p = FindKeyValuePair(key);
         return p ? &p->Value : nullptr;
     }
 
-    const ValueType* FindValue(const KeyType& key) const
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const ValueType* FindValue(const LookupKeyType& key) const
     {
         auto p = FindKeyValuePair(key);
         return p ? &p->Value : nullptr;
@@ -499,23 +1072,25 @@ public:
 
     int32_t GetNumElements() const
     {
-        return m_Keys.GetNumElements();
+        return m_Entries.GetNumElements();
     }
 
     template <typename OtherAllocatorType>
-    void GetKeys(TArray<KeyType, OtherAllocatorType>& outKeys)
+    void GetKeys(TArray<KeyType, OtherAllocatorType>& outKeys) const
     {
-        outKeys.Append(m_Keys);
-    }
+        outKeys.AllocAbs(outKeys.GetNumElements() + m_Entries.GetNumElements());
 
-    void Clear()
-    {
-        for (auto& hash : m_Hashes)
+        for (const KeyValueType& entry : m_Entries)
         {
-            hash = 0;
+            outKeys.Add(entry.Key);
         }
+    }
 
-        m_Keys.Empty();
+    void Clear()
+    {
+        m_Entries.Empty();
+        m_Hashes.Empty();
+        m_Index.Clear();
     }
 
     bool Contains(const KeyType& key) const
@@ -523,66 +1098,50 @@ public:
         return !!FindKeyValuePair(key);
     }
 
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return !!FindKeyValuePair(key);
+    }
+
+    /* Load factor, probe lengths and rehash counters of the index, for diagnosing slow maps */
+    FHashTableStats GetStats() const
+    {
+        return m_Index.GetStats();
+    }
+
 private:
+    /* Dense entries and their hashes, stored at the same indices */
+    TArray<KeyValueType, AllocatorType> m_Entries;
     TArray<uint64_t, AllocatorType> m_Hashes;
-    TArray<TKeyValue<KeyType, ValueType>, AllocatorType> m_Buckets;
-    TArray<KeyType, AllocatorType> m_Keys;
+
+    THashIndex<AllocatorType> m_Index;
 
     HashFunction m_HashFunction;
     EqualCompare m_EqualCompare;
 
 private:
-    bool LookupIndex(const KeyType& key, int32_t& outIndex) const
+    template <typename LookupKeyType>
+    int32_t FindEntryIndex(const LookupKeyType& key, uint64_t hash) const
     {
-        if (m_Buckets.IsEmpty() || m_Keys.IsEmpty())
-        {
-            return false;
-        }
-
-        uint64_t hash = m_HashFunction(key);
-        int32_t pos = static_cast<int32_t>(hash % m_Buckets.GetNumAlloc());
-
-        if (m_Hashes[pos] == 0)
-        {
-            return false;
-        }
-
-        if (m_Hashes[pos] == hash && m_EqualCompare(key, m_Buckets[pos].Key))
+        return m_Index.Find(hash, [this, &key](int32_t entryIndex)
         {
-            outIndex = pos;
-            return true;
-        }
-
-        return false;
+            return m_EqualCompare(key, m_Entries[entryIndex].Key);
+        });
     }
 
-    void Rehash()
+    template <typename ...Args>
+    void AddEntry(uint64_t hash, Args&& ...args)
     {
-        TArray<uint64_t, AllocatorType> newHashes;
-        TArray<TKeyValue<KeyType, ValueType>, AllocatorType> newBuckets;
-
-        if (m_Buckets.IsEmpty())
-        {
-            newHashes.AddZeroed(16);
-            newBuckets.AddZeroed(16);
-        }
-        else
-        {
-            newHashes.AddZeroed(2 * m_Hashes.GetNumElements());
-            newBuckets.AddZeroed(2 * m_Buckets.GetNumElements());
-        }
+        int32_t index = m_Entries.GetNumElements();
 
-        for (auto& v : this->m_Buckets)
+        if (m_Index.IsFull(index + 1))
         {
-            uint64_t hash = m_HashFunction(v.Key);
-            int32_t pos = static_cast<int32_t>(hash % newBuckets.GetNumAlloc());
-
-            newHashes[pos] = hash;
-            newBuckets[pos] = v;
+            m_Index.Grow(index + 1, m_Hashes.GetData(), index);
         }
 
-        m_Hashes = std::move(newHashes);
-        m_Buckets = std::move(newBuckets);
+        m_Entries.EmplaceBack(std::forward<Args>(args)...);
+        m_Hashes.Add(hash);
+        m_Index.Insert(hash, index);
     }
 };
-
@@ -0,0 +1,143 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FMappedFile::FMappedFile(FMappedFile&& other) noexcept :
+    m_Data(std::exchange(other.m_Data, nullptr)),
+    m_Size(std::exchange(other.m_Size, 0)),
+    m_Mapping(std::exchange(other.m_Mapping, nullptr))
+{
+}
+
+FMappedFile& FMappedFile::operator=(FMappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_Mapping = std::exchange(other.m_Mapping, nullptr);
+    }
+
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool FMappedFile::Open(const char* path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    /* Mapping keeps the file open, so file handle isn't needed anymore */
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+    {
+        return false;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_Data = static_cast<const uint8_t*>(data);
+    m_Size = static_cast<uint64_t>(size.QuadPart);
+    m_Mapping = mapping;
+
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (m_Data)
+    {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+    }
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapping = nullptr;
+}
+
+#else
+
+bool FMappedFile::Open(const char* path)
+{
+    Close();
+
+    int file = open(path, O_RDONLY);
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status{};
+
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    /* Mapping keeps the file open, so descriptor isn't needed anymore */
+    void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_Data = static_cast<const uint8_t*>(data);
+    m_Size = static_cast<uint64_t>(status.st_size);
+
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (m_Data)
+    {
+        munmap(const_cast<uint8_t*>(m_Data), static_cast<size_t>(m_Size));
+    }
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapping = nullptr;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+* Whole file mapped read-only into memory. Pages are loaded by OS on first access and shared
+* between all processes, which map the same file
+*/
+class FMappedFile
+{
+public:
+    FMappedFile() = default;
+
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+
+    FMappedFile(FMappedFile&& other) noexcept;
+    FMappedFile& operator=(FMappedFile&& other) noexcept;
+
+    ~FMappedFile() noexcept
+    {
+        Close();
+    }
+
+    /* Returns false if file can't be opened or is empty */
+    bool Open(const char* path);
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_Data != nullptr;
+    }
+
+    const uint8_t* GetData() const
+    {
+        return m_Data;
+    }
+
+    uint64_t GetSize() const
+    {
+        return m_Size;
+    }
+
+private:
+    const uint8_t* m_Data = nullptr;
+    uint64_t m_Size = 0;
+
+    /* File mapping object handle, used only on Windows */
+    void* m_Mapping = nullptr;
+};
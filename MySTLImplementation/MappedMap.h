@@ -0,0 +1,376 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Optional.h"
+#include "String.h"
+
+namespace impl
+{
+    /* Location of string bytes in blob section */
+    struct FMappedString
+    {
+        uint64_t Offset;
+        uint64_t Length;
+    };
+
+    /* Trivially copyable types are stored as they are */
+    template <typename T>
+    struct TMappedTraits
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "TMappedMap supports only trivially copyable and string like types");
+
+        using StoredType = T;
+        using ViewType = T;
+
+        static StoredType Store(const T& value, TArray<char>&)
+        {
+            return value;
+        }
+
+        static ViewType View(const StoredType& stored, const char*)
+        {
+            return stored;
+        }
+
+        /* Keys are hashed and compared by bytes, so hash doesn't depend on process or build */
+        static uint64_t Hash(const ViewType& key)
+        {
+            static_assert(std::has_unique_object_representations_v<T>, "TMappedMap key must not contain padding or floating point");
+            return Hashing::HashBytes(&key, sizeof(T));
+        }
+
+        static bool Equals(const StoredType& stored, const char*, const ViewType& key)
+        {
+            return memcmp(&stored, &key, sizeof(T)) == 0;
+        }
+    };
+
+    /* Strings are stored as offset and length into blob and viewed as std::string_view */
+    template <TStringLike T>
+    struct TMappedTraits<T>
+    {
+        using StoredType = FMappedString;
+        using ViewType = std::string_view;
+
+        static StoredType Store(const T& value, TArray<char>& blob)
+        {
+            std::string_view view = value;
+            StoredType stored{static_cast<uint64_t>(blob.GetNumElements()), view.size()};
+            blob.Append(view.data(), static_cast<int32_t>(view.size()));
+            return stored;
+        }
+
+        static ViewType View(const StoredType& stored, const char* blob)
+        {
+            return ViewType{blob + stored.Offset, static_cast<size_t>(stored.Length)};
+        }
+
+        static uint64_t Hash(const ViewType& key)
+        {
+            return Hashing::HashBytes(key.data(), key.size());
+        }
+
+        static bool Equals(const StoredType& stored, const char* blob, const ViewType& key)
+        {
+            return View(stored, blob) == key;
+        }
+    };
+}
+
+/*
+* Read-only hash table stored in file, which is used directly from memory mapping without deserialization.
+* File is written once by Write from any map and opened by Open in O(1): all references inside are offsets
+* from file start, so the mapping can be placed at any address and its pages are shared by all processes.
+* Keys and values must be trivially copyable or string like, strings are returned as std::string_view into mapping.
+* Format is native endian and files are trusted (Open checks header, not every entry)
+*/
+template <typename KeyType, typename ValueType>
+class TMappedMap
+{
+    using KeyTraits = impl::TMappedTraits<KeyType>;
+    using ValueTraits = impl::TMappedTraits<ValueType>;
+
+public:
+    using KeyViewType = typename KeyTraits::ViewType;
+    using ValueViewType = typename ValueTraits::ViewType;
+
+    TMappedMap() = default;
+
+    /* Maps file and validates its header. Returns false if file is missing or wasn't written for this key and value types */
+    bool Open(const char* path)
+    {
+        Close();
+
+        if (!m_File.Open(path) || !Validate())
+        {
+            Close();
+            return false;
+        }
+
+        const uint8_t* data = m_File.GetData();
+        const FHeader* header = reinterpret_cast<const FHeader*>(data);
+
+        m_Entries = reinterpret_cast<const FEntry*>(data + header->EntriesOffset);
+        m_Slots = reinterpret_cast<const FSlot*>(data + header->SlotsOffset);
+        m_Blob = reinterpret_cast<const char*>(data + header->BlobOffset);
+        m_NumEntries = header->NumEntries;
+        m_SlotMask = header->NumSlots - 1;
+
+        return true;
+    }
+
+    void Close()
+    {
+        m_File.Close();
+
+        m_Entries = nullptr;
+        m_Slots = nullptr;
+        m_Blob = nullptr;
+        m_NumEntries = 0;
+        m_SlotMask = 0;
+    }
+
+    bool IsOpen() const
+    {
+        return m_File.IsOpen();
+    }
+
+    TOptional<ValueViewType> Find(const KeyViewType& key) const
+    {
+        const FEntry* entry = FindEntry(key);
+        return entry ? TOptional<ValueViewType>{ValueTraits::View(entry->Value, m_Blob)} : TOptional<ValueViewType>{NullOpt};
+    }
+
+    bool Contains(const KeyViewType& key) const
+    {
+        return FindEntry(key) != nullptr;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return static_cast<int32_t>(m_NumEntries);
+    }
+
+    /* Calls func(KeyViewType, ValueViewType) for every entry in file order */
+    template <typename FuncType>
+    void ForEach(FuncType&& func) const
+    {
+        for (uint32_t i = 0; i < m_NumEntries; ++i)
+        {
+            func(KeyTraits::View(m_Entries[i].Key, m_Blob), ValueTraits::View(m_Entries[i].Value, m_Blob));
+        }
+    }
+
+    /*
+    * Writes all key value pairs of map (TMap, TFrozenMap or anything iterable over TKeyValue) into file.
+    * Table has at least twice as many slots as entries, so lookups rarely probe more than one slot
+    */
+    template <typename MapType>
+    static bool Write(const MapType& map, const char* path)
+    {
+        TArray<FEntry> entries;
+        TArray<uint64_t> hashes;
+        TArray<char> blob;
+
+        for (const auto& keyValue : map)
+        {
+            /* Zeroed, so padding bytes in file are deterministic */
+            FEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.Key = KeyTraits::Store(keyValue.Key, blob);
+            entry.Value = ValueTraits::Store(keyValue.Value, blob);
+
+            entries.Add(entry);
+            hashes.Add(KeyTraits::Hash(KeyTraits::View(entry.Key, blob.GetData())));
+        }
+
+        uint32_t numSlots = 1;
+
+        while (numSlots < 2u * static_cast<uint32_t>(entries.GetNumElements()))
+        {
+            numSlots *= 2;
+        }
+
+        TArray<FSlot> slots;
+        slots.AddZeroed(static_cast<int32_t>(numSlots));
+
+        for (FSlot& slot : slots)
+        {
+            slot.EntryIndex = EmptySlot;
+        }
+
+        for (int32_t i = 0; i < entries.GetNumElements(); ++i)
+        {
+            uint32_t slot = static_cast<uint32_t>(hashes[i]) & (numSlots - 1);
+
+            while (slots[slot].EntryIndex != EmptySlot)
+            {
+                slot = (slot + 1) & (numSlots - 1);
+            }
+
+            slots[slot] = FSlot{static_cast<uint32_t>(hashes[i] >> 32), static_cast<uint32_t>(i)};
+        }
+
+        FHeader header;
+        memset(&header, 0, sizeof(header));
+        header.Magic = Magic;
+        header.Version = Version;
+        header.KeySize = sizeof(typename KeyTraits::StoredType);
+        header.ValueSize = sizeof(typename ValueTraits::StoredType);
+        header.EntrySize = sizeof(FEntry);
+        header.NumEntries = static_cast<uint32_t>(entries.GetNumElements());
+        header.NumSlots = numSlots;
+        header.EntriesOffset = AlignOffset(sizeof(FHeader));
+        header.SlotsOffset = AlignOffset(header.EntriesOffset + sizeof(FEntry) * header.NumEntries);
+        header.BlobOffset = AlignOffset(header.SlotsOffset + sizeof(FSlot) * numSlots);
+        header.BlobSize = static_cast<uint64_t>(blob.GetNumElements());
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+        if (!file)
+        {
+            return false;
+        }
+
+        uint64_t position = 0;
+
+        auto writeSection = [&file, &position](uint64_t offset, const void* data, uint64_t size)
+        {
+            constexpr char padding[SectionAlignment]{};
+            file.write(padding, static_cast<std::streamsize>(offset - position));
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            position = offset + size;
+        };
+
+        writeSection(0, &header, sizeof(header));
+        writeSection(header.EntriesOffset, entries.GetData(), sizeof(FEntry) * header.NumEntries);
+        writeSection(header.SlotsOffset, slots.GetData(), sizeof(FSlot) * numSlots);
+        writeSection(header.BlobOffset, blob.GetData(), header.BlobSize);
+
+        return static_cast<bool>(file.flush());
+    }
+
+private:
+    using StoredKeyType = typename KeyTraits::StoredType;
+    using StoredValueType = typename ValueTraits::StoredType;
+
+    /* "MMAP" in file bytes on little endian machine, doesn't match on machine with other endianness */
+    constexpr static uint32_t Magic = 0x50414D4Du;
+    constexpr static uint32_t Version = 1;
+
+    constexpr static uint32_t EmptySlot = ~0u;
+
+    /* Sections start at cache line boundary, which also satisfies alignment of any stored type */
+    constexpr static uint64_t SectionAlignment = 64;
+
+    struct FHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t KeySize;
+        uint32_t ValueSize;
+        uint32_t EntrySize;
+        uint32_t NumEntries;
+        uint32_t NumSlots;
+        uint32_t Reserved;
+        uint64_t EntriesOffset;
+        uint64_t SlotsOffset;
+        uint64_t BlobOffset;
+        uint64_t BlobSize;
+    };
+
+    struct FEntry
+    {
+        StoredKeyType Key;
+        StoredValueType Value;
+    };
+
+    /* Upper half of hash is compared before touching entry */
+    struct FSlot
+    {
+        uint32_t HashTag;
+        uint32_t EntryIndex;
+    };
+
+    static_assert(alignof(FEntry) <= SectionAlignment);
+
+    FMappedFile m_File;
+
+    const FEntry* m_Entries = nullptr;
+    const FSlot* m_Slots = nullptr;
+    const char* m_Blob = nullptr;
+    uint32_t m_NumEntries = 0;
+    uint32_t m_SlotMask = 0;
+
+private:
+    static uint64_t AlignOffset(uint64_t offset)
+    {
+        return (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+    }
+
+    const FEntry* FindEntry(const KeyViewType& key) const
+    {
+        if (!m_Slots)
+        {
+            return nullptr;
+        }
+
+        uint64_t hash = KeyTraits::Hash(key);
+        uint32_t hashTag = static_cast<uint32_t>(hash >> 32);
+
+        for (uint32_t slot = static_cast<uint32_t>(hash) & m_SlotMask;; slot = (slot + 1) & m_SlotMask)
+        {
+            const FSlot& current = m_Slots[slot];
+
+            if (current.EntryIndex == EmptySlot)
+            {
+                return nullptr;
+            }
+
+            if (current.HashTag == hashTag && KeyTraits::Equals(m_Entries[current.EntryIndex].Key, m_Blob, key))
+            {
+                return &m_Entries[current.EntryIndex];
+            }
+        }
+    }
+
+    bool Validate() const
+    {
+        uint64_t size = m_File.GetSize();
+
+        if (size < sizeof(FHeader))
+        {
+            return false;
+        }
+
+        const FHeader* header = reinterpret_cast<const FHeader*>(m_File.GetData());
+
+        if (header->Magic != Magic || header->Version != Version || header->KeySize != sizeof(StoredKeyType) ||
+            header->ValueSize != sizeof(StoredValueType) || header->EntrySize != sizeof(FEntry))
+        {
+            return false;
+        }
+
+        /* Empty slot must exist, otherwise lookup of missing key wouldn't terminate */
+        if (header->NumSlots == 0 || (header->NumSlots & (header->NumSlots - 1)) != 0 || header->NumSlots <= header->NumEntries)
+        {
+            return false;
+        }
+
+        auto isSectionValid = [size](uint64_t offset, uint64_t sectionSize)
+        {
+            return offset % SectionAlignment == 0 && offset <= size && sectionSize <= size - offset;
+        };
+
+        return isSectionValid(header->EntriesOffset, sizeof(FEntry) * header->NumEntries) &&
+            isSectionValid(header->SlotsOffset, sizeof(FSlot) * header->NumSlots) &&
+            isSectionValid(header->BlobOffset, header->BlobSize);
+    }
+};
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include "Map.h"
+
+/* Walks values of one key through chain of node indices */
+template <typename NodeType, typename ValueType>
+class TMultiMapValueIterator
+{
+public:
+    using SelfClass = TMultiMapValueIterator<NodeType, ValueType>;
+
+    TMultiMapValueIterator(NodeType* nodes, int32_t index) :
+        m_Nodes{nodes},
+        m_Index{index}
+    {
+    }
+
+    SelfClass& operator++()
+    {
+        m_Index = m_Nodes[m_Index].Next;
+        return *this;
+    }
+
+    SelfClass operator++(int)
+    {
+        SelfClass copy{*this};
+        ++*this;
+        return copy;
+    }
+
+    ValueType& operator*() const
+    {
+        return m_Nodes[m_Index].Value;
+    }
+
+    ValueType* operator->() const
+    {
+        return &m_Nodes[m_Index].Value;
+    }
+
+    bool operator==(const SelfClass& other) const
+    {
+        return m_Index == other.m_Index;
+    }
+
+    bool operator!=(const SelfClass& other) const
+    {
+        return m_Index != other.m_Index;
+    }
+
+private:
+    NodeType* m_Nodes;
+    int32_t m_Index;
+};
+
+/* Values of one key, returned by TMultiMap::Find. Invalidated by any modification of the map */
+template <typename NodeType, typename ValueType>
+class TMultiMapValueRange
+{
+public:
+    using Iterator = TMultiMapValueIterator<NodeType, ValueType>;
+
+    TMultiMapValueRange(NodeType* nodes, int32_t head, int32_t numElements) :
+        m_Nodes{nodes},
+        m_Head{head},
+        m_NumElements{numElements}
+    {
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_NumElements;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_NumElements == 0;
+    }
+
+    Iterator begin() const
+    {
+        return Iterator{m_Nodes, m_Head};
+    }
+
+    Iterator end() const
+    {
+        return Iterator{m_Nodes, IndexNone};
+    }
+
+private:
+    NodeType* m_Nodes;
+    int32_t m_Head;
+    int32_t m_NumElements;
+};
+
+/*
+* Map from key to any number of values. All values live in single node pool, values of the same key are chained
+* through node indices in insertion order, removed nodes are reused through free list. Compared to TMap<Key, TArray<Value>>
+* there is no allocation per key, AddValue is O(1) and RemoveValue is linear only in number of values of its key.
+* Compact regroups pool, so values of each key are adjacent
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TMultiMap
+{
+    struct FValueNode
+    {
+        ValueType Value{};
+        int32_t Next = IndexNone;
+    };
+
+public:
+    using ValueRange = TMultiMapValueRange<FValueNode, ValueType>;
+    using ConstValueRange = TMultiMapValueRange<const FValueNode, const ValueType>;
+
+    TMultiMap() = default;
+
+    void AddValue(const KeyType& key, const ValueType& value)
+    {
+        AddValueImpl(key, value);
+    }
+
+    void AddValue(const KeyType& key, ValueType&& value)
+    {
+        AddValueImpl(key, std::move(value));
+    }
+
+    /* Removes first value of key, which equals to value. Key without values is removed. Returns false if nothing was removed */
+    bool RemoveValue(const KeyType& key, const ValueType& value)
+    {
+        FChain* chain = m_Chains.FindValue(key);
+
+        if (!chain)
+        {
+            return false;
+        }
+
+        for (int32_t prev = IndexNone, node = chain->Head; node != IndexNone; prev = node, node = m_Nodes[node].Next)
+        {
+            if (m_Nodes[node].Value == value)
+            {
+                int32_t next = m_Nodes[node].Next;
+
+                if (prev != IndexNone)
+                {
+                    m_Nodes[prev].Next = next;
+                }
+                else
+                {
+                    chain->Head = next;
+                }
+
+                if (chain->Tail == node)
+                {
+                    chain->Tail = prev;
+                }
+
+                FreeNode(node);
+
+                if (--chain->NumValues == 0)
+                {
+                    m_Chains.Remove(key);
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Removes key with all its values, returns number of removed values */
+    int32_t Remove(const KeyType& key)
+    {
+        const FChain* chain = m_Chains.FindValue(key);
+
+        if (!chain)
+        {
+            return 0;
+        }
+
+        int32_t numValues = chain->NumValues;
+
+        for (int32_t node = chain->Head; node != IndexNone;)
+        {
+            int32_t next = m_Nodes[node].Next;
+            FreeNode(node);
+            node = next;
+        }
+
+        m_Chains.Remove(key);
+
+        return numValues;
+    }
+
+    ValueRange Find(const KeyType& key)
+    {
+        return MakeRange(m_Nodes.GetData(), m_Chains.FindValue(key));
+    }
+
+    ConstValueRange Find(const KeyType& key) const
+    {
+        return MakeRange(m_Nodes.GetData(), m_Chains.FindValue(key));
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    ValueRange Find(const LookupKeyType& key)
+    {
+        return MakeRange(m_Nodes.GetData(), m_Chains.FindValue(key));
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    ConstValueRange Find(const LookupKeyType& key) const
+    {
+        return MakeRange(m_Nodes.GetData(), m_Chains.FindValue(key));
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return m_Chains.Contains(key);
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return m_Chains.Contains(key);
+    }
+
+    int32_t GetNumValues(const KeyType& key) const
+    {
+        const FChain* chain = m_Chains.FindValue(key);
+        return chain ? chain->NumValues : 0;
+    }
+
+    int32_t GetNumKeys() const
+    {
+        return m_Chains.GetNumElements();
+    }
+
+    int32_t GetNumValues() const
+    {
+        return m_NumValues;
+    }
+
+    template <typename OtherAllocatorType>
+    void GetKeys(TArray<KeyType, OtherAllocatorType>& outKeys) const
+    {
+        m_Chains.GetKeys(outKeys);
+    }
+
+    /* Calls func(const KeyType&, const ValueType&) for every value, values of one key are visited together */
+    template <typename FuncType>
+    void ForEach(FuncType&& func) const
+    {
+        for (const auto& [key, chain] : m_Chains)
+        {
+            for (int32_t node = chain.Head; node != IndexNone; node = m_Nodes[node].Next)
+            {
+                func(key, m_Nodes[node].Value);
+            }
+        }
+    }
+
+    /* Allocates pool for numValues values */
+    void Reserve(int32_t numValues)
+    {
+        m_Nodes.AllocAbs(numValues);
+    }
+
+    void Clear()
+    {
+        m_Chains.Clear();
+        m_Nodes.Empty();
+        m_FreeList = IndexNone;
+        m_NumValues = 0;
+    }
+
+    /* Rebuilds pool without free nodes, values of each key are stored adjacent in order, so Find walks memory linearly */
+    void Compact()
+    {
+        TArray<FValueNode, AllocatorType> nodes;
+        nodes.AllocAbs(m_NumValues);
+
+        for (auto& [key, chain] : m_Chains)
+        {
+            int32_t head = nodes.GetNumElements();
+
+            for (int32_t node = chain.Head; node != IndexNone; node = m_Nodes[node].Next)
+            {
+                nodes.Add(FValueNode{std::move(m_Nodes[node].Value), nodes.GetNumElements() + 1});
+            }
+
+            nodes[nodes.GetNumElements() - 1].Next = IndexNone;
+            chain.Head = head;
+            chain.Tail = nodes.GetNumElements() - 1;
+        }
+
+        m_Nodes.swap(nodes);
+        m_FreeList = IndexNone;
+    }
+
+private:
+    /* First and last node of values of key */
+    struct FChain
+    {
+        int32_t Head = IndexNone;
+        int32_t Tail = IndexNone;
+        int32_t NumValues = 0;
+    };
+
+    TMap<KeyType, FChain, HashFunction, EqualCompare, AllocatorType> m_Chains;
+    TArray<FValueNode, AllocatorType> m_Nodes;
+
+    /* Free nodes are linked through Next */
+    int32_t m_FreeList = IndexNone;
+    int32_t m_NumValues = 0;
+
+private:
+    template <typename NodeType>
+    static TMultiMapValueRange<NodeType, std::conditional_t<std::is_const_v<NodeType>, const ValueType, ValueType>> MakeRange(NodeType* nodes,
+        const FChain* chain)
+    {
+        return {nodes, chain ? chain->Head : IndexNone, chain ? chain->NumValues : 0};
+    }
+
+    template <typename ValueArgType>
+    void AddValueImpl(const KeyType& key, ValueArgType&& value)
+    {
+        int32_t node = AllocateNode(std::forward<ValueArgType>(value));
+        FChain* chain = m_Chains.FindValue(key);
+
+        if (!chain)
+        {
+            m_Chains.Insert(key, FChain{node, node, 1});
+            return;
+        }
+
+        m_Nodes[chain->Tail].Next = node;
+        chain->Tail = node;
+        ++chain->NumValues;
+    }
+
+    template <typename ValueArgType>
+    int32_t AllocateNode(ValueArgType&& value)
+    {
+        ++m_NumValues;
+
+        if (m_FreeList == IndexNone)
+        {
+            m_Nodes.Add(FValueNode{std::forward<ValueArgType>(value), IndexNone});
+            return m_Nodes.GetNumElements() - 1;
+        }
+
+        int32_t node = m_FreeList;
+        m_FreeList = m_Nodes[node].Next;
+        m_Nodes[node] = FValueNode{std::forward<ValueArgType>(value), IndexNone};
+
+        return node;
+    }
+
+    /* Releases value and puts node to free list */
+    void FreeNode(int32_t node)
+    {
+        --m_NumValues;
+
+        m_Nodes[node] = FValueNode{ValueType{}, m_FreeList};
+        m_FreeList = node;
+    }
+};
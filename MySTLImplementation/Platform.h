@@ -0,0 +1,18 @@
+#pragma once
+
+/* SSE2 is baseline on every x64 target, on x86 it depends on compiler flags */
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLATFORM_SSE2 1
+#include <emmintrin.h>
+#else
+#define PLATFORM_SSE2 0
+#endif
+
+/* Hint to bring cache line with given address to all cache levels */
+#if PLATFORM_SSE2
+#define PLATFORM_PREFETCH(Address) _mm_prefetch(reinterpret_cast<const char*>(Address), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define PLATFORM_PREFETCH(Address) __builtin_prefetch(Address)
+#else
+#define PLATFORM_PREFETCH(Address)
+#endif
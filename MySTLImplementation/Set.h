@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <initializer_list>
+
+#include "Map.h"
+#include "Span.h"
+
+/*
+* Hash set, built the same way as TMap: elements densely packed in single array, their hashes in parallel array
+* and THashIndex pointing into it. Remove is O(1) (last element is moved into freed place).
+* Set operations iterate the smaller set and reuse stored hashes, so elements are never hashed twice
+*/
+template <typename ElementType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TSet
+{
+public:
+    using SelfClass = TSet<ElementType, HashFunction, EqualCompare, AllocatorType>;
+
+    /* Elements are immutable, changing them would break the index */
+    using ConstIterator = TMapIterator<const ElementType>;
+
+    TSet() = default;
+
+    TSet(std::initializer_list<ElementType> elements)
+    {
+        Append(TSpan<const ElementType>{elements.begin(), static_cast<int32_t>(elements.size())});
+    }
+
+    explicit TSet(TSpan<const ElementType> elements)
+    {
+        Append(elements);
+    }
+
+    /* Returns true, if element was added, false if it already was in the set */
+    bool Add(const ElementType& element)
+    {
+        return AddWithHash(m_HashFunction(element), element);
+    }
+
+    bool Add(ElementType&& element)
+    {
+        uint64_t hash = m_HashFunction(element);
+        return AddWithHash(hash, std::move(element));
+    }
+
+    void Append(TSpan<const ElementType> elements)
+    {
+        Reserve(m_Elements.GetNumElements() + elements.GetNumElements());
+
+        for (const ElementType& element : elements)
+        {
+            Add(element);
+        }
+    }
+
+    /* Stored hashes of other set are reused */
+    void Append(const SelfClass& other)
+    {
+        Reserve(m_Elements.GetNumElements() + other.GetNumElements());
+
+        for (int32_t i = 0; i < other.GetNumElements(); ++i)
+        {
+            AddWithHash(other.m_Hashes[i], other.m_Elements[i]);
+        }
+    }
+
+    /* Allocates elements and index for numElements, so adding up to that many elements doesn't rehash */
+    void Reserve(int32_t numElements)
+    {
+        m_Elements.AllocAbs(numElements);
+        m_Hashes.AllocAbs(numElements);
+
+        if (m_Index.IsFull(numElements))
+        {
+            m_Index.Grow(numElements, m_Hashes.GetData(), m_Hashes.GetNumElements());
+        }
+    }
+
+    /* Returns true, if element was in the set */
+    bool Remove(const ElementType& element)
+    {
+        return RemoveWithHash(m_HashFunction(element), element);
+    }
+
+    bool Contains(const ElementType& element) const
+    {
+        return FindIndex(element, m_HashFunction(element)) != IndexNone;
+    }
+
+    template <typename LookupType> requires THeterogeneousLookup<LookupType, ElementType, HashFunction, EqualCompare>
+    bool Contains(const LookupType& element) const
+    {
+        return FindIndex(element, m_HashFunction(element)) != IndexNone;
+    }
+
+    /* Returns stored element equal to given one or nullptr */
+    const ElementType* Find(const ElementType& element) const
+    {
+        int32_t index = FindIndex(element, m_HashFunction(element));
+        return index != IndexNone ? &m_Elements[index] : nullptr;
+    }
+
+    template <typename LookupType> requires THeterogeneousLookup<LookupType, ElementType, HashFunction, EqualCompare>
+    const ElementType* Find(const LookupType& element) const
+    {
+        int32_t index = FindIndex(element, m_HashFunction(element));
+        return index != IndexNone ? &m_Elements[index] : nullptr;
+    }
+
+    /* Elements in either of sets */
+    SelfClass Union(const SelfClass& other) const
+    {
+        const SelfClass& larger = GetNumElements() >= other.GetNumElements() ? *this : other;
+        const SelfClass& smaller = &larger == this ? other : *this;
+
+        SelfClass result{larger};
+        result.Append(smaller);
+        return result;
+    }
+
+    /* Elements in both sets */
+    SelfClass Intersect(const SelfClass& other) const
+    {
+        const SelfClass& larger = GetNumElements() >= other.GetNumElements() ? *this : other;
+        const SelfClass& smaller = &larger == this ? other : *this;
+
+        SelfClass result;
+        result.Reserve(smaller.GetNumElements());
+
+        for (int32_t i = 0; i < smaller.GetNumElements(); ++i)
+        {
+            if (larger.FindIndex(smaller.m_Elements[i], smaller.m_Hashes[i]) != IndexNone)
+            {
+                result.AddUnchecked(smaller.m_Hashes[i], smaller.m_Elements[i]);
+            }
+        }
+
+        return result;
+    }
+
+    /* Elements of this set, which are not in other set */
+    SelfClass Difference(const SelfClass& other) const
+    {
+        if (other.GetNumElements() < GetNumElements())
+        {
+            SelfClass result{*this};
+
+            for (int32_t i = 0; i < other.GetNumElements(); ++i)
+            {
+                result.RemoveWithHash(other.m_Hashes[i], other.m_Elements[i]);
+            }
+
+            return result;
+        }
+
+        SelfClass result;
+
+        for (int32_t i = 0; i < GetNumElements(); ++i)
+        {
+            if (other.FindIndex(m_Elements[i], m_Hashes[i]) == IndexNone)
+            {
+                result.AddUnchecked(m_Hashes[i], m_Elements[i]);
+            }
+        }
+
+        return result;
+    }
+
+    /* Returns true, if every element of other set is in this set */
+    bool Includes(const SelfClass& other) const
+    {
+        if (other.GetNumElements() > GetNumElements())
+        {
+            return false;
+        }
+
+        for (int32_t i = 0; i < other.GetNumElements(); ++i)
+        {
+            if (FindIndex(other.m_Elements[i], other.m_Hashes[i]) == IndexNone)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_Elements.GetNumElements();
+    }
+
+    bool IsEmpty() const
+    {
+        return m_Elements.IsEmpty();
+    }
+
+    void Clear()
+    {
+        m_Elements.Empty();
+        m_Hashes.Empty();
+        m_Index.Clear();
+    }
+
+    FHashTableStats GetStats() const
+    {
+        return m_Index.GetStats();
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator{m_Elements.UncheckedBegin()};
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator{m_Elements.UncheckedEnd()};
+    }
+
+    operator TSpan<const ElementType>() const
+    {
+        return TSpan<const ElementType>{m_Elements.GetData(), m_Elements.GetNumElements()};
+    }
+
+private:
+    /* Dense elements and their hashes, stored at the same indices */
+    TArray<ElementType, AllocatorType> m_Elements;
+    TArray<uint64_t, AllocatorType> m_Hashes;
+
+    THashIndex<AllocatorType> m_Index;
+
+    HashFunction m_HashFunction;
+    EqualCompare m_EqualCompare;
+
+private:
+    template <typename LookupType>
+    int32_t FindIndex(const LookupType& element, uint64_t hash) const
+    {
+        return m_Index.Find(hash, [this, &element](int32_t index)
+        {
+            return m_EqualCompare(element, m_Elements[index]);
+        });
+    }
+
+    template <typename ArgType>
+    bool AddWithHash(uint64_t hash, ArgType&& element)
+    {
+        if (FindIndex(element, hash) != IndexNone)
+        {
+            return false;
+        }
+
+        AddUnchecked(hash, std::forward<ArgType>(element));
+        return true;
+    }
+
+    /* Element must not be in the set */
+    template <typename ArgType>
+    void AddUnchecked(uint64_t hash, ArgType&& element)
+    {
+        int32_t index = m_Elements.GetNumElements();
+
+        if (m_Index.IsFull(index + 1))
+        {
+            m_Index.Grow(index + 1, m_Hashes.GetData(), index);
+        }
+
+        m_Elements.EmplaceBack(std::forward<ArgType>(element));
+        m_Hashes.Add(hash);
+        m_Index.Insert(hash, index);
+    }
+
+    bool RemoveWithHash(uint64_t hash, const ElementType& element)
+    {
+        int32_t slot = m_Index.FindSlot(hash, [this, &element](int32_t index)
+        {
+            return m_EqualCompare(element, m_Elements[index]);
+        });
+
+        if (slot == IndexNone)
+        {
+            return false;
+        }
+
+        int32_t index = m_Index.GetEntryIndex(slot);
+        int32_t lastIndex = m_Elements.GetNumElements() - 1;
+
+        m_Index.RemoveSlot(slot);
+
+        if (index != lastIndex)
+        {
+            m_Index.Relink(m_Hashes[lastIndex], lastIndex, index);
+        }
+
+        m_Elements.RemoveIndexSwap(index);
+        m_Hashes.RemoveIndexSwap(index);
+        return true;
+    }
+};
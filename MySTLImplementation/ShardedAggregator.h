@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Map.h"
+
+/*
+* Aggregation (counting, summing, grouping) from many threads without shared lock. Every worker acquires its own TMap
+* shard once and writes into it without synchronization. Merge combines all shards into partitions with disjoint keys:
+* first shards are split by hash partition, then every partition is merged by its own thread, so no two threads
+* ever write the same map. Merge can be repeated, new shards are combined into existing partitions
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TShardedAggregator
+{
+public:
+    using MapType = TMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType>;
+    using KeyValueType = typename MapType::KeyValueType;
+
+    /* numPartitions is rounded up to power of two, 0 means one partition per hardware thread */
+    explicit TShardedAggregator(int32_t numPartitions = 0)
+    {
+        int32_t numRequested = numPartitions > 0 ? numPartitions : GetDefaultNumThreads();
+        m_NumPartitions = 1;
+
+        while (m_NumPartitions < numRequested)
+        {
+            m_NumPartitions *= 2;
+        }
+
+        m_Partitions.AddZeroed(m_NumPartitions);
+    }
+
+    TShardedAggregator(const TShardedAggregator&) = delete;
+    TShardedAggregator& operator=(const TShardedAggregator&) = delete;
+
+    /*
+    * Returns new empty shard owned by aggregator. Meant to be called once per worker thread, the shard must be
+    * used only by that thread and only until Merge
+    */
+    MapType& AcquireShard()
+    {
+        std::lock_guard lock{m_ShardsMutex};
+
+        m_Shards.Add(std::make_unique<MapType>());
+        return *m_Shards[m_Shards.GetNumElements() - 1];
+    }
+
+    /*
+    * Combines contents of all shards into partitions, calling combine(ValueType& accumulated, const ValueType& value)
+    * for keys found in more than one shard. Shards are released, workers must not use them during or after Merge.
+    * numThreads == 0 uses one thread per hardware thread
+    */
+    template <typename CombineFunc>
+    void Merge(CombineFunc&& combine, int32_t numThreads = 0)
+    {
+        std::lock_guard lock{m_ShardsMutex};
+
+        int32_t numShards = m_Shards.GetNumElements();
+
+        if (numShards == 0)
+        {
+            return;
+        }
+
+        if (numThreads <= 0)
+        {
+            numThreads = GetDefaultNumThreads();
+        }
+
+        /* Entries of shard s, which belong to partition p, are at scattered[s * m_NumPartitions + p] */
+        TArray<TArray<const KeyValueType*>> scattered;
+        scattered.AddZeroed(numShards * m_NumPartitions);
+
+        ParallelFor(numShards, numThreads, [this, &scattered](int32_t shard)
+        {
+            TArray<const KeyValueType*>* shardPartitions = &scattered[shard * m_NumPartitions];
+
+            for (const KeyValueType& keyValue : std::as_const(*m_Shards[shard]))
+            {
+                shardPartitions[GetPartitionIndex(m_HashFunction(keyValue.Key))].Add(&keyValue);
+            }
+        });
+
+        ParallelFor(m_NumPartitions, numThreads, [this, &scattered, &combine, numShards](int32_t partition)
+        {
+            MapType& result = m_Partitions[partition];
+            int32_t largestShard = 0;
+
+            for (int32_t shard = 0; shard < numShards; ++shard)
+            {
+                largestShard = std::max(largestShard, scattered[shard * m_NumPartitions + partition].GetNumElements());
+            }
+
+            /* Distinct keys are at least as many as in the largest shard, usually not much more for aggregation */
+            result.Reserve(result.GetNumElements() + largestShard);
+
+            for (int32_t shard = 0; shard < numShards; ++shard)
+            {
+                for (const KeyValueType* keyValue : scattered[shard * m_NumPartitions + partition])
+                {
+                    if (ValueType* accumulated = result.FindValue(keyValue->Key))
+                    {
+                        combine(*accumulated, keyValue->Value);
+                    }
+                    else
+                    {
+                        result.Insert(keyValue->Key, keyValue->Value);
+                    }
+                }
+            }
+        });
+
+        m_Shards.Empty();
+    }
+
+    /* Looks up merged value, shards which weren't merged yet aren't visible */
+    const ValueType* FindValue(const KeyType& key) const
+    {
+        return m_Partitions[GetPartitionIndex(m_HashFunction(key))].FindValue(key);
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const ValueType* FindValue(const LookupKeyType& key) const
+    {
+        return m_Partitions[GetPartitionIndex(m_HashFunction(key))].FindValue(key);
+    }
+
+    int32_t GetNumPartitions() const
+    {
+        return m_NumPartitions;
+    }
+
+    /* Keys of different partitions never overlap */
+    const MapType& GetPartition(int32_t partition) const
+    {
+        return m_Partitions[partition];
+    }
+
+    int32_t GetNumElements() const
+    {
+        int32_t numElements = 0;
+
+        for (const MapType& partition : m_Partitions)
+        {
+            numElements += partition.GetNumElements();
+        }
+
+        return numElements;
+    }
+
+    /* Calls func(const KeyType&, const ValueType&) for every merged entry */
+    template <typename FuncType>
+    void ForEach(FuncType&& func) const
+    {
+        for (const MapType& partition : m_Partitions)
+        {
+            for (const KeyValueType& keyValue : partition)
+            {
+                func(keyValue.Key, keyValue.Value);
+            }
+        }
+    }
+
+    /* Copies all partitions into single map, keys are disjoint, so nothing has to be combined */
+    MapType ToMap() const
+    {
+        MapType map;
+        map.Reserve(GetNumElements());
+
+        for (const MapType& partition : m_Partitions)
+        {
+            map.Append(partition);
+        }
+
+        return map;
+    }
+
+    /* Drops merged results and unmerged shards */
+    void Clear()
+    {
+        std::lock_guard lock{m_ShardsMutex};
+
+        m_Shards.Empty();
+
+        for (MapType& partition : m_Partitions)
+        {
+            partition.Clear();
+        }
+    }
+
+private:
+    TArray<std::unique_ptr<MapType>> m_Shards;
+    std::mutex m_ShardsMutex;
+
+    TArray<MapType> m_Partitions;
+    int32_t m_NumPartitions;
+
+    HashFunction m_HashFunction;
+
+private:
+    static int32_t GetDefaultNumThreads()
+    {
+        return std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    }
+
+    /* High bits of remixed hash, so partition doesn't correlate with slot position inside partition map */
+    int32_t GetPartitionIndex(uint64_t hash) const
+    {
+        return static_cast<int32_t>(((hash * 0x9E3779B97F4A7C15ull) >> 32) & static_cast<uint64_t>(m_NumPartitions - 1));
+    }
+
+    /* Runs func(index) for every index in [0, numTasks) on up to numThreads threads, including calling one */
+    template <typename FuncType>
+    static void ParallelFor(int32_t numTasks, int32_t numThreads, const FuncType& func)
+    {
+        std::atomic<int32_t> nextTask{0};
+
+        auto worker = [&nextTask, &func, numTasks]()
+        {
+            for (int32_t task = nextTask.fetch_add(1, std::memory_order_relaxed); task < numTasks; task = nextTask.fetch_add(1, std::memory_order_relaxed))
+            {
+                func(task);
+            }
+        };
+
+        TArray<std::thread> threads;
+        int32_t numWorkers = std::min(numThreads, numTasks) - 1;
+
+        for (int32_t i = 0; i < numWorkers; ++i)
+        {
+            threads.Add(std::thread{worker});
+        }
+
+        worker();
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+};
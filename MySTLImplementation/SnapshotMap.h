@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "Map.h"
+#include "Optional.h"
+
+/*
+* Read-mostly map. Readers pin the current TMap with Read() and never lock or wait: pinning is one atomic increment
+* of reader counter plus pointer load. Writers build complete new map and publish it with single pointer swap,
+* so readers see either old or new table, never partially updated one. Old table is deleted only after
+* every reader, which could have seen it, released its guard (RCU style grace period).
+* Writes are expensive (copy or rebuild of whole map), use it for tables updated rarely and read constantly
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TSnapshotMap
+{
+public:
+    using MapType = TMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType>;
+
+    /* Keeps snapshot alive. Must not outlive TSnapshotMap and shouldn't be held across Publish in the same thread (deadlock) */
+    class FReadGuard
+    {
+    public:
+        FReadGuard(const FReadGuard&) = delete;
+        FReadGuard& operator=(const FReadGuard&) = delete;
+
+        FReadGuard(FReadGuard&& guard) noexcept :
+            m_ReaderCounter{guard.m_ReaderCounter},
+            m_Map{guard.m_Map}
+        {
+            guard.m_ReaderCounter = nullptr;
+            guard.m_Map = nullptr;
+        }
+
+        ~FReadGuard() noexcept
+        {
+            if (m_ReaderCounter)
+            {
+                m_ReaderCounter->fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        const MapType& operator*() const
+        {
+            return *m_Map;
+        }
+
+        const MapType* operator->() const
+        {
+            return m_Map;
+        }
+
+    private:
+        friend class TSnapshotMap;
+
+        FReadGuard(std::atomic<int32_t>* readerCounter, const MapType* map) :
+            m_ReaderCounter{readerCounter},
+            m_Map{map}
+        {
+        }
+
+        std::atomic<int32_t>* m_ReaderCounter;
+        const MapType* m_Map;
+    };
+
+public:
+    TSnapshotMap() :
+        m_Current{new MapType{}}
+    {
+    }
+
+    explicit TSnapshotMap(MapType&& map) :
+        m_Current{new MapType{std::move(map)}}
+    {
+    }
+
+    TSnapshotMap(const TSnapshotMap&) = delete;
+    TSnapshotMap& operator=(const TSnapshotMap&) = delete;
+
+    ~TSnapshotMap() noexcept
+    {
+        delete m_Current.load(std::memory_order_relaxed);
+    }
+
+    /* Wait-free, snapshot stays valid and unchanged until guard is destroyed */
+    FReadGuard Read() const
+    {
+        /* Counter is incremented before loading pointer, so writer that swapped pointer after that will wait for us */
+        std::atomic<int32_t>& readerCounter = m_ReaderCounters[m_Epoch.load(std::memory_order_seq_cst) & 1].Value;
+        readerCounter.fetch_add(1, std::memory_order_seq_cst);
+
+        return FReadGuard{&readerCounter, m_Current.load(std::memory_order_seq_cst)};
+    }
+
+    TOptional<ValueType> Find(const KeyType& key) const
+    {
+        FReadGuard guard = Read();
+        const ValueType* value = guard->FindValue(key);
+        return value ? TOptional<ValueType>{*value} : TOptional<ValueType>{NullOpt};
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return Read()->Contains(key);
+    }
+
+    int32_t GetNumElements() const
+    {
+        return Read()->GetNumElements();
+    }
+
+    /* Replaces whole table. Returns after previous table was reclaimed */
+    void Publish(MapType&& map)
+    {
+        std::lock_guard lock{m_WriterMutex};
+        PublishLocked(new MapType{std::move(map)});
+    }
+
+    /* Copies current table, applies func(MapType&) to the copy and publishes it. Concurrent writers are serialized */
+    template <typename FuncType>
+    void Update(FuncType&& func)
+    {
+        std::lock_guard lock{m_WriterMutex};
+
+        MapType* newMap = new MapType{*m_Current.load(std::memory_order_relaxed)};
+        func(*newMap);
+        PublishLocked(newMap);
+    }
+
+    void Insert(const KeyType& key, const ValueType& value)
+    {
+        Update([&key, &value](MapType& map)
+        {
+            map.Insert(key, value);
+        });
+    }
+
+    void Remove(const KeyType& key)
+    {
+        Update([&key](MapType& map)
+        {
+            map.Remove(key);
+        });
+    }
+
+private:
+    struct alignas(64) FReaderCounter
+    {
+        std::atomic<int32_t> Value{0};
+    };
+
+    std::atomic<MapType*> m_Current;
+    alignas(64) std::atomic<uint32_t> m_Epoch{0};
+    mutable FReaderCounter m_ReaderCounters[2];
+    std::mutex m_WriterMutex;
+
+private:
+    void PublishLocked(MapType* newMap)
+    {
+        MapType* oldMap = m_Current.exchange(newMap, std::memory_order_seq_cst);
+
+        /*
+        * Every reader of oldMap incremented one of two counters before the exchange. Epoch is flipped before waiting
+        * on each counter, so new readers go to the other counter and can't keep waited one above zero forever
+        */
+        for (int32_t i = 0; i < 2; ++i)
+        {
+            uint32_t epoch = m_Epoch.load(std::memory_order_relaxed);
+            m_Epoch.store(epoch + 1, std::memory_order_seq_cst);
+
+            std::atomic<int32_t>& readerCounter = m_ReaderCounters[epoch & 1].Value;
+
+            while (readerCounter.load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        delete oldMap;
+    }
+};
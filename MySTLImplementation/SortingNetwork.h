@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <utility>
+#include <type_traits>
+
+#include "Algorithm.h"
+#include "Span.h"
+
+/* Sorting networks are used for ranges up to this size */
+constexpr inline int32_t MaxSortingNetworkSize = 32;
+
+template <typename ElementType>
+concept TSortingNetworkElement = std::is_arithmetic_v<ElementType>;
+
+struct FSortingNetworkComparator
+{
+    int8_t First;
+    int8_t Second;
+};
+
+/*
+* Fixed sequence of compare-exchange operations (Batcher's odd-even merge sort), which sorts exactly N elements.
+* Sequence is generated at compile time and fully unrolled, each compare-exchange is branchless min/max pair,
+* so there are no data dependent branches like in introsort
+*/
+template <int32_t N>
+class TSortingNetwork
+{
+    static_assert(N >= 0 && N <= MaxSortingNetworkSize, "Sorting network size out of range");
+
+public:
+    template <TSortingNetworkElement ElementType>
+    constexpr static void Sort(ElementType* data)
+    {
+        SortImpl(data, std::make_index_sequence<NumComparators>{});
+    }
+
+    template <TSortingNetworkElement ElementType>
+    constexpr static void Sort(TSpan<ElementType> span)
+    {
+        assert(span.GetNumElements() == N);
+        Sort(span.GetData());
+    }
+
+    constexpr static int32_t GetNumComparators()
+    {
+        return NumComparators;
+    }
+
+private:
+    constexpr static int32_t GetPaddedSize()
+    {
+        int32_t size = 1;
+
+        while (size < N)
+        {
+            size *= 2;
+        }
+
+        return size;
+    }
+
+    /* Visits comparators of network for padded power of two size, skipping those that touch padding (padding acts as +infinity) */
+    template <typename Func>
+    constexpr static void ForEachComparator(Func&& func)
+    {
+        constexpr int32_t paddedSize = GetPaddedSize();
+
+        for (int32_t p = 1; p < paddedSize; p *= 2)
+        {
+            for (int32_t k = p; k >= 1; k /= 2)
+            {
+                for (int32_t j = k % p; j + k < paddedSize; j += 2 * k)
+                {
+                    for (int32_t i = 0; i < k && i + j + k < paddedSize; ++i)
+                    {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < N)
+                        {
+                            func(i + j, i + j + k);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    constexpr static int32_t CountComparators()
+    {
+        int32_t count = 0;
+        ForEachComparator([&count](int32_t, int32_t)
+        {
+            ++count;
+        });
+
+        return count;
+    }
+
+    constexpr static int32_t NumComparators = CountComparators();
+
+    struct FComparators
+    {
+        FSortingNetworkComparator Data[NumComparators > 0 ? NumComparators : 1];
+    };
+
+    constexpr static FComparators BuildComparators()
+    {
+        FComparators comparators{};
+        int32_t count = 0;
+
+        ForEachComparator([&comparators, &count](int32_t first, int32_t second)
+        {
+            comparators.Data[count++] = FSortingNetworkComparator{static_cast<int8_t>(first), static_cast<int8_t>(second)};
+        });
+
+        return comparators;
+    }
+
+    constexpr static FComparators Comparators = BuildComparators();
+
+    template <typename ElementType>
+    constexpr static void CompareExchange(ElementType& a, ElementType& b)
+    {
+        ElementType low = b < a ? b : a;
+        ElementType high = b < a ? a : b;
+        a = low;
+        b = high;
+    }
+
+    /* Networks for N < 2 have no comparators, so data isn't used */
+    template <typename ElementType, size_t ...Indices>
+    constexpr static void SortImpl([[maybe_unused]] ElementType* data, std::index_sequence<Indices...>)
+    {
+        (CompareExchange(data[Comparators.Data[Indices].First], data[Comparators.Data[Indices].Second]), ...);
+    }
+};
+
+class SortingNetworks
+{
+public:
+    /* Sorts range ascending, using sorting network for sizes up to MaxSortingNetworkSize and Arrays::Sort above that */
+    template <TSortingNetworkElement ElementType>
+    static void Sort(ElementType* data, int32_t numElements)
+    {
+        if (numElements > MaxSortingNetworkSize)
+        {
+            Arrays::Sort(data, data + numElements, std::less<ElementType>{});
+            return;
+        }
+
+        constexpr auto sortFunctions = MakeSortFunctions<ElementType>(std::make_index_sequence<MaxSortingNetworkSize + 1>{});
+        sortFunctions[numElements](data);
+    }
+
+    template <TSortingNetworkElement ElementType>
+    static void Sort(TSpan<ElementType> span)
+    {
+        Sort(span.GetData(), span.GetNumElements());
+    }
+
+private:
+    template <typename ElementType>
+    using SortFunction = void(*)(ElementType*);
+
+    template <typename ElementType, size_t ...Sizes>
+    constexpr static auto MakeSortFunctions(std::index_sequence<Sizes...>)
+    {
+        using FunctionTable = SortFunction<ElementType>[sizeof...(Sizes)];
+
+        struct FTable
+        {
+            FunctionTable Functions;
+
+            constexpr SortFunction<ElementType> operator[](int32_t index) const
+            {
+                return Functions[index];
+            }
+        };
+
+        return FTable{{&TSortingNetwork<static_cast<int32_t>(Sizes)>::template Sort<ElementType>...}};
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Algorithm.h"
+#include "Array.h"
+#include "Map.h"
+
+namespace impl
+{
+    /* Not constexpr on purpose: reaching it during constant evaluation makes the build fail, at runtime it aborts */
+    [[noreturn]] inline void StaticMapDuplicateKey()
+    {
+        std::fputs("TStaticMap keys must be unique\n", stderr);
+        std::abort();
+    }
+}
+
+/*
+* Map with fixed set of entries, which is built and sorted at compile time, so it needs no runtime initialization.
+* Meant for lookup tables like enum to string and back: keys can be integers, enums or std::string_view
+* (lookups accept any string like type). CString can't be a key, because it isn't constexpr constructible,
+* use std::string_view keys and look them up with CString. Find is branchless binary search, FindKey is linear reverse lookup
+*/
+template <typename KeyType, typename ValueType, int32_t Size, typename Predicate = DefaultLessCompare>
+class TStaticMap
+{
+    static_assert(Size > 0, "TStaticMap must have at least one entry");
+
+public:
+    using KeyValueType = TKeyValue<KeyType, ValueType>;
+    using ConstIterator = typename TStaticArray<KeyValueType, Size>::ConstIterator;
+
+    constexpr explicit TStaticMap(const TStaticArray<KeyValueType, Size>& keyValues) :
+        m_Entries{keyValues}
+    {
+        Arrays::Sort(m_Entries.GetData(), m_Entries.GetData() + Size, [](const KeyValueType& a, const KeyValueType& b)
+        {
+            return Predicate{}(a.Key, b.Key);
+        });
+
+        /* Checked in release builds too, duplicate key would make lookup results depend on sort order */
+        for (int32_t i = 1; i < Size; ++i)
+        {
+            if (!Predicate{}(m_Entries[i - 1].Key, m_Entries[i].Key))
+            {
+                impl::StaticMapDuplicateKey();
+            }
+        }
+    }
+
+    template <typename LookupKeyType>
+    constexpr const KeyValueType* FindKeyValuePair(const LookupKeyType& key) const
+    {
+        Predicate less{};
+        const KeyValueType* base = m_Entries.GetData();
+        int32_t numElements = Size;
+
+        /* Halving without early exit, loop count depends only on Size and select compiles to conditional move */
+        while (numElements > 1)
+        {
+            int32_t half = numElements / 2;
+            base = less(base[half - 1].Key, key) ? base + half : base;
+            numElements -= half;
+        }
+
+        return !less(base->Key, key) && !less(key, base->Key) ? base : nullptr;
+    }
+
+    template <typename LookupKeyType>
+    constexpr const ValueType* FindValue(const LookupKeyType& key) const
+    {
+        const KeyValueType* keyValue = FindKeyValuePair(key);
+        return keyValue ? &keyValue->Value : nullptr;
+    }
+
+    template <typename LookupKeyType>
+    constexpr bool Contains(const LookupKeyType& key) const
+    {
+        return FindKeyValuePair(key) != nullptr;
+    }
+
+    /* Returns key of first entry (in key order) with given value or nullptr */
+    constexpr const KeyType* FindKey(const ValueType& value) const
+    {
+        for (const KeyValueType& keyValue : m_Entries.Data)
+        {
+            if (keyValue.Value == value)
+            {
+                return &keyValue.Key;
+            }
+        }
+
+        return nullptr;
+    }
+
+    template <typename LookupKeyType>
+    constexpr const ValueType& operator[](const LookupKeyType& key) const
+    {
+        const ValueType* value = FindValue(key);
+        CHECK_ITEM_EXISTS(value);
+        return *value;
+    }
+
+    constexpr int32_t GetNumElements() const
+    {
+        return Size;
+    }
+
+    constexpr ConstIterator begin() const
+    {
+        return m_Entries.begin();
+    }
+
+    constexpr ConstIterator end() const
+    {
+        return m_Entries.end();
+    }
+
+private:
+    TStaticArray<KeyValueType, Size> m_Entries;
+};
+
+/* Allows to write MakeStaticMap<std::string_view, EColor>({{"Red", EColor::Red}, {"Green", EColor::Green}}) */
+template <typename KeyType, typename ValueType, int32_t Size>
+constexpr TStaticMap<KeyType, ValueType, Size> MakeStaticMap(const TKeyValue<KeyType, ValueType> (&keyValues)[Size])
+{
+    TStaticArray<TKeyValue<KeyType, ValueType>, Size> entries{};
+
+    for (int32_t i = 0; i < Size; ++i)
+    {
+        entries[i] = keyValues[i];
+    }
+
+    return TStaticMap<KeyType, ValueType, Size>{entries};
+}
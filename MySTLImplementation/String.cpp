@@ -162,18 +162,7 @@ int32_t String::RFind(const char* str, int32_t endOffset) const
 
 uint64_t String::GetHashCode() const
 {
-    /* simple djb2 hashing */
-    const char* it = m_Data.GetData();
-    uint64_t hashv = 5381;
-    uint64_t c = *it++;
-
-    while (c)
-    {
-        hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-        c = *it++;
-    }
-
-    return hashv;
+    return IsEmpty() ? CharTraits::GetHash(nullptr, 0) : CharTraits::GetHash(m_Data.GetData(), GetLength());
 }
 
 #define MAX_PRINTF_BUFFER 4096
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Array.h"
+#include "Hash.h"
 
 #include <cstring>
 #include <cstdlib>
@@ -66,8 +67,17 @@ struct TCharTraits
     {
         return memcmp(a, b, count * sizeof(T));
     }
+
+    static uint64_t GetHash(const T* str, int32_t length)
+    {
+        return Hashing::HashBytes(str, static_cast<size_t>(length) * sizeof(T));
+    }
 };
 
+/* Types, which can be viewed as characters range (String, CString, std::string, std::string_view, const char*) */
+template <typename T>
+concept TStringLike = std::is_convertible_v<const T&, std::string_view>;
+
 class String
 {
 public:
@@ -146,6 +156,11 @@ public:
         return m_Data.GetData();
     }
 
+    operator std::string_view() const
+    {
+        return IsEmpty() ? std::string_view{} : std::string_view{m_Data.GetData(), static_cast<size_t>(GetLength())};
+    }
+
     void Clear();
 
     std::ostream& operator<<(std::ostream& stream) const;
@@ -0,0 +1,605 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <bit>
+#include <utility>
+
+#include "Map.h"
+#include "Platform.h"
+
+namespace impl
+{
+    /* Control byte of slot. Full slots store 7 low bits of hash (0..127), special values have highest bit set */
+    enum class ESwissControl : int8_t
+    {
+        Empty = -128,
+        Deleted = -2
+    };
+
+    /* 16 control bytes, which are compared with single SSE2 instruction */
+    class TSwissGroup
+    {
+    public:
+        constexpr static int32_t Width = 16;
+
+        explicit TSwissGroup(const int8_t* control)
+        {
+#if PLATFORM_SSE2
+            m_Control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+            std::memcpy(m_Control, control, Width);
+#endif
+        }
+
+        /* Bit mask of slots, which control byte equals hash fragment */
+        uint32_t Match(int8_t hashFragment) const
+        {
+#if PLATFORM_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hashFragment), m_Control)));
+#else
+            return MatchScalar([hashFragment](int8_t control) { return control == hashFragment; });
+#endif
+        }
+
+        uint32_t MatchEmpty() const
+        {
+            return Match(static_cast<int8_t>(ESwissControl::Empty));
+        }
+
+        /* Empty and deleted are the only negative control bytes */
+        uint32_t MatchEmptyOrDeleted() const
+        {
+#if PLATFORM_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(m_Control));
+#else
+            return MatchScalar([](int8_t control) { return control < 0; });
+#endif
+        }
+
+    private:
+#if PLATFORM_SSE2
+        __m128i m_Control;
+#else
+        int8_t m_Control[Width];
+
+        template <typename Predicate>
+        uint32_t MatchScalar(Predicate&& predicate) const
+        {
+            uint32_t mask = 0;
+
+            for (int32_t i = 0; i < Width; ++i)
+            {
+                mask |= predicate(m_Control[i]) ? (1u << i) : 0u;
+            }
+
+            return mask;
+        }
+#endif
+    };
+}
+
+template <typename MapType, typename KeyValueType>
+class TSwissMapIterator
+{
+public:
+    using SelfClass = TSwissMapIterator<MapType, KeyValueType>;
+
+    TSwissMapIterator(MapType& map, int32_t index) :
+        m_Map{&map},
+        m_Index{index}
+    {
+        SkipEmptySlots();
+    }
+
+    TSwissMapIterator(const SelfClass&) = default;
+    TSwissMapIterator& operator=(const SelfClass&) = default;
+
+    SelfClass& operator++()
+    {
+        ++m_Index;
+        SkipEmptySlots();
+        return *this;
+    }
+
+    SelfClass operator++(int)
+    {
+        SelfClass it{*this};
+        ++(*this);
+        return it;
+    }
+
+    KeyValueType& operator*() const
+    {
+        return *m_Map->GetSlot(m_Index);
+    }
+
+    KeyValueType* operator->() const
+    {
+        return m_Map->GetSlot(m_Index);
+    }
+
+    bool operator==(const SelfClass& other) const
+    {
+        return m_Index == other.m_Index;
+    }
+
+    bool operator!=(const SelfClass& other) const
+    {
+        return m_Index != other.m_Index;
+    }
+
+private:
+    MapType* m_Map;
+    int32_t m_Index;
+
+    void SkipEmptySlots()
+    {
+        while (m_Index < m_Map->GetCapacity() && !m_Map->IsSlotFull(m_Index))
+        {
+            ++m_Index;
+        }
+    }
+};
+
+/*
+* Hash map in style of swiss tables. Next to slots there is separate array of control bytes,
+* each holding 7 bits of key hash. Lookup compares 16 control bytes at once and touches slots only
+* for matching fragments, so misses rarely compare any key.
+* Has same template parameters and interface as TMap, so they can be swapped
+*/
+template <typename KeyType, typename ValueType, typename HashFunction = DefaultHashFunctions, typename EqualCompare = DefaultEqualCompare,
+    typename AllocatorType = DefaultAllocator>
+class TSwissMap
+{
+    template <typename MapType, typename KeyValueType>
+    friend class TSwissMapIterator;
+
+    using Group = impl::TSwissGroup;
+    using ESwissControl = impl::ESwissControl;
+
+    constexpr static int32_t MinCapacity = Group::Width;
+
+public:
+    using KeyValueType = TKeyValue<KeyType, ValueType>;
+    using SelfClass = TSwissMap<KeyType, ValueType, HashFunction, EqualCompare, AllocatorType>;
+
+    using Iterator = TSwissMapIterator<SelfClass, KeyValueType>;
+    using ConstIterator = TSwissMapIterator<const SelfClass, const KeyValueType>;
+
+    TSwissMap() = default;
+
+    TSwissMap(const SelfClass& map)
+    {
+        Append(map);
+    }
+
+    TSwissMap& operator=(const SelfClass& map)
+    {
+        if (&map != this)
+        {
+            Clear();
+            Append(map);
+        }
+
+        return *this;
+    }
+
+    TSwissMap(SelfClass&& map) noexcept :
+        m_Control(std::exchange(map.m_Control, nullptr)),
+        m_Slots(std::exchange(map.m_Slots, nullptr)),
+        m_Capacity(std::exchange(map.m_Capacity, 0)),
+        m_NumElements(std::exchange(map.m_NumElements, 0)),
+        m_GrowthLeft(std::exchange(map.m_GrowthLeft, 0))
+    {
+    }
+
+    TSwissMap& operator=(SelfClass&& map) noexcept
+    {
+        if (&map != this)
+        {
+            DestroyTable();
+
+            m_Control = std::exchange(map.m_Control, nullptr);
+            m_Slots = std::exchange(map.m_Slots, nullptr);
+            m_Capacity = std::exchange(map.m_Capacity, 0);
+            m_NumElements = std::exchange(map.m_NumElements, 0);
+            m_GrowthLeft = std::exchange(map.m_GrowthLeft, 0);
+        }
+
+        return *this;
+    }
+
+    ~TSwissMap() noexcept
+    {
+        DestroyTable();
+    }
+
+    template <typename OtherMapType>
+    void Append(const OtherMapType& map)
+    {
+        for (auto& [key, value] : map)
+        {
+            Insert(key, value);
+        }
+    }
+
+    void Insert(const KeyType& key, const ValueType& value)
+    {
+        uint64_t hash = m_HashFunction(key);
+        int32_t index = FindIndex(key, hash);
+
+        if (index != IndexNone)
+        {
+            m_Slots[index].Value = value;
+            return;
+        }
+
+        index = PrepareInsert(hash);
+        m_Allocator.ConstructElement(&m_Slots[index], key, value);
+    }
+
+    void Remove(const KeyType& key)
+    {
+        int32_t index = FindIndex(key, m_HashFunction(key));
+
+        if (index != IndexNone)
+        {
+            m_Allocator.DestroyRange(&m_Slots[index], &m_Slots[index + 1]);
+            SetControl(index, static_cast<int8_t>(ESwissControl::Deleted));
+            --m_NumElements;
+        }
+    }
+
+    /* Returns key value pair or nullptr if couldn't be find. Key property must not be changed */
+    KeyValueType* FindKeyValuePair(const KeyType& key)
+    {
+        int32_t index = FindIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Slots[index] : nullptr;
+    }
+
+    /* Returns key value pair or nullptr if couldn't be find. Key property must not be changed */
+    const KeyValueType* FindKeyValuePair(const KeyType& key) const
+    {
+        int32_t index = FindIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Slots[index] : nullptr;
+    }
+
+    ValueType* FindValue(const KeyType& key)
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
+
+    const ValueType* FindValue(const KeyType& key) const
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
+
+    const ValueType& operator[](const KeyType& key) const
+    {
+        auto valuePtr = FindValue(key);
+        assert(valuePtr);
+        return *valuePtr;
+    }
+
+    ValueType& operator[](const KeyType& key)
+    {
+        auto valuePtr = FindValue(key);
+        assert(valuePtr);
+        return *valuePtr;
+    }
+
+    bool Contains(const KeyType& key) const
+    {
+        return FindIndex(key, m_HashFunction(key)) != IndexNone;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    KeyValueType* FindKeyValuePair(const LookupKeyType& key)
+    {
+        int32_t index = FindIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Slots[index] : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const KeyValueType* FindKeyValuePair(const LookupKeyType& key) const
+    {
+        int32_t index = FindIndex(key, m_HashFunction(key));
+        return index != IndexNone ? &m_Slots[index] : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    ValueType* FindValue(const LookupKeyType& key)
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    const ValueType* FindValue(const LookupKeyType& key) const
+    {
+        auto p = FindKeyValuePair(key);
+        return p ? &p->Value : nullptr;
+    }
+
+    template <typename LookupKeyType> requires THeterogeneousLookup<LookupKeyType, KeyType, HashFunction, EqualCompare>
+    bool Contains(const LookupKeyType& key) const
+    {
+        return FindIndex(key, m_HashFunction(key)) != IndexNone;
+    }
+
+    int32_t GetNumElements() const
+    {
+        return m_NumElements;
+    }
+
+    int32_t GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+    /* Probe length is number of groups visited before the group containing element. Walks whole table */
+    FHashTableStats GetStats() const
+    {
+        FHashTableStats stats;
+        stats.NumElements = m_NumElements;
+        stats.NumSlots = m_Capacity;
+        stats.LoadFactor = m_Capacity > 0 ? static_cast<double>(m_NumElements) / m_Capacity : 0.0;
+
+        for (int32_t i = 0; i < m_Capacity; ++i)
+        {
+            if (IsSlotFull(i))
+            {
+                stats.AddProbeLength(GetProbeLength(i, m_HashFunction(m_Slots[i].Key)));
+            }
+        }
+
+        m_RehashCounter.FillStats(stats);
+
+        return stats;
+    }
+
+    template <typename OtherAllocatorType>
+    void GetKeys(TArray<KeyType, OtherAllocatorType>& outKeys) const
+    {
+        outKeys.AllocAbs(outKeys.GetNumElements() + m_NumElements);
+
+        for (const KeyValueType& keyValue : *this)
+        {
+            outKeys.Add(keyValue.Key);
+        }
+    }
+
+    void Clear()
+    {
+        for (int32_t i = 0; i < m_Capacity; ++i)
+        {
+            if (IsSlotFull(i))
+            {
+                m_Allocator.DestroyRange(&m_Slots[i], &m_Slots[i + 1]);
+            }
+        }
+
+        if (m_Control)
+        {
+            std::memset(m_Control, static_cast<int8_t>(ESwissControl::Empty), m_Capacity + Group::Width);
+        }
+
+        m_NumElements = 0;
+        m_GrowthLeft = GetMaxNumElements(m_Capacity);
+    }
+
+    Iterator begin()
+    {
+        return Iterator{*this, 0};
+    }
+
+    Iterator end()
+    {
+        return Iterator{*this, m_Capacity};
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator{*this, 0};
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator{*this, m_Capacity};
+    }
+
+private:
+    /* Capacity + Group::Width bytes. Last Group::Width bytes mirror first ones, so group can be loaded at any slot */
+    int8_t* m_Control{nullptr};
+    KeyValueType* m_Slots{nullptr};
+    int32_t m_Capacity{0};
+    int32_t m_NumElements{0};
+
+    /* Number of empty slots, which can be still used before load factor is exceeded. Deleted slots aren't counted */
+    int32_t m_GrowthLeft{0};
+
+    HashFunction m_HashFunction;
+    EqualCompare m_EqualCompare;
+    AllocatorType m_Allocator;
+
+    FHashRehashCounter m_RehashCounter;
+
+private:
+    static int8_t GetHashFragment(uint64_t hash)
+    {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    int32_t GetHomeSlot(uint64_t hash) const
+    {
+        return static_cast<int32_t>((hash >> 7) & (m_Capacity - 1));
+    }
+
+    /* Table is kept at most 7/8 full */
+    static int32_t GetMaxNumElements(int32_t capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    bool IsSlotFull(int32_t index) const
+    {
+        return m_Control[index] >= 0;
+    }
+
+    KeyValueType* GetSlot(int32_t index) const
+    {
+        return &m_Slots[index];
+    }
+
+    void SetControl(int32_t index, int8_t control)
+    {
+        m_Control[index] = control;
+
+        if (index < Group::Width)
+        {
+            m_Control[m_Capacity + index] = control;
+        }
+    }
+
+    template <typename LookupKeyType>
+    int32_t FindIndex(const LookupKeyType& key, uint64_t hash) const
+    {
+        if (m_NumElements == 0)
+        {
+            return IndexNone;
+        }
+
+        int32_t mask = m_Capacity - 1;
+        int8_t fragment = GetHashFragment(hash);
+        int32_t position = GetHomeSlot(hash);
+
+        /* Triangular probing over groups visits every group, when capacity is power of two */
+        for (int32_t step = Group::Width; ; position = (position + step) & mask, step += Group::Width)
+        {
+            Group group{m_Control + position};
+
+            for (uint32_t match = group.Match(fragment); match != 0; match &= match - 1)
+            {
+                int32_t index = (position + std::countr_zero(match)) & mask;
+
+                if (m_EqualCompare(key, m_Slots[index].Key))
+                {
+                    return index;
+                }
+            }
+
+            if (group.MatchEmpty() != 0)
+            {
+                return IndexNone;
+            }
+        }
+    }
+
+    /* Repeats probe sequence of hash until group window covers index */
+    int32_t GetProbeLength(int32_t index, uint64_t hash) const
+    {
+        int32_t mask = m_Capacity - 1;
+        int32_t position = GetHomeSlot(hash);
+        int32_t probeLength = 0;
+
+        for (int32_t step = Group::Width; ((index - position) & mask) >= Group::Width; position = (position + step) & mask, step += Group::Width)
+        {
+            ++probeLength;
+        }
+
+        return probeLength;
+    }
+
+    int32_t FindFirstNonFull(uint64_t hash) const
+    {
+        int32_t mask = m_Capacity - 1;
+        int32_t position = GetHomeSlot(hash);
+
+        for (int32_t step = Group::Width; ; position = (position + step) & mask, step += Group::Width)
+        {
+            uint32_t match = Group{m_Control + position}.MatchEmptyOrDeleted();
+
+            if (match != 0)
+            {
+                return (position + std::countr_zero(match)) & mask;
+            }
+        }
+    }
+
+    /* Reserves slot for new key and marks it as full. Slot memory is left unconstructed */
+    int32_t PrepareInsert(uint64_t hash)
+    {
+        if (m_Capacity == 0)
+        {
+            Resize(MinCapacity);
+        }
+
+        int32_t index = FindFirstNonFull(hash);
+
+        if (m_GrowthLeft == 0 && m_Control[index] == static_cast<int8_t>(ESwissControl::Empty))
+        {
+            /* When most of used slots are tombstones, cleaning them is enough */
+            Resize(m_NumElements * 2 < GetMaxNumElements(m_Capacity) ? m_Capacity : m_Capacity * 2);
+            index = FindFirstNonFull(hash);
+        }
+
+        if (m_Control[index] == static_cast<int8_t>(ESwissControl::Empty))
+        {
+            --m_GrowthLeft;
+        }
+
+        SetControl(index, GetHashFragment(hash));
+        ++m_NumElements;
+
+        return index;
+    }
+
+    void Resize(int32_t newCapacity)
+    {
+        FHashRehashCounter::FScope rehashScope{m_RehashCounter};
+
+        int8_t* oldControl = m_Control;
+        KeyValueType* oldSlots = m_Slots;
+        int32_t oldCapacity = m_Capacity;
+
+        m_Control = (int8_t*)m_Allocator.Allocate(newCapacity + Group::Width);
+        m_Slots = (KeyValueType*)m_Allocator.Allocate(static_cast<intptr_t>(newCapacity) * sizeof(KeyValueType));
+        m_Capacity = newCapacity;
+        m_GrowthLeft = GetMaxNumElements(newCapacity) - m_NumElements;
+
+        std::memset(m_Control, static_cast<int8_t>(ESwissControl::Empty), newCapacity + Group::Width);
+
+        for (int32_t i = 0; i < oldCapacity; ++i)
+        {
+            if (oldControl[i] >= 0)
+            {
+                uint64_t hash = m_HashFunction(oldSlots[i].Key);
+                int32_t index = FindFirstNonFull(hash);
+
+                SetControl(index, GetHashFragment(hash));
+                m_Allocator.ConstructElement(&m_Slots[index], std::move(oldSlots[i]));
+                m_Allocator.DestroyRange(&oldSlots[i], &oldSlots[i + 1]);
+            }
+        }
+
+        m_Allocator.Free(oldControl);
+        m_Allocator.Free(oldSlots);
+    }
+
+    void DestroyTable()
+    {
+        Clear();
+
+        m_Allocator.Free(m_Control);
+        m_Allocator.Free(m_Slots);
+
+        m_Control = nullptr;
+        m_Slots = nullptr;
+        m_Capacity = 0;
+        m_GrowthLeft = 0;
+    }
+};